@@ -9,8 +9,11 @@
 //	Include files
 //
 
+#include <bitset>
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <map>
 
 #ifndef IMGUI_DEFINE_MATH_OPERATORS
 #define IMGUI_DEFINE_MATH_OPERATORS
@@ -27,9 +30,19 @@
 
 void TextEditor::setText(const std::string_view &text) {
 	// load text into document and reset subsystems
-	document.setText(text);
+	// (large read-only files are only indexed)
+	if (readOnly && largeFileThreshold && text.size() >= largeFileThreshold) {
+		document.setLazyText(text);
+
+	} else {
+		document.setText(text);
+	}
+
+	decodedLines.clear();
+	decodedLineIndex.clear();
 	transactions.clear();
 	bracketeer.reset();
+	layout.reset(document.lineCount());
 	cursors.clearAll();
 	makeCursorVisible();
 }
@@ -61,6 +74,11 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 		decorationOffset = lineNumberLeftOffset;
 	}
 
+	if (folding) {
+		foldOffset = decorationOffset;
+		decorationOffset += glyphSize.x;
+	}
+
 	if (decoratorWidth > 0.0f) {
 		textOffset = decorationOffset + decoratorWidth + decorationMargin * glyphSize.x;
 
@@ -68,9 +86,12 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 		textOffset = decorationOffset + textMargin * glyphSize.x;
 	}
 
+	// determine minimap width (a glyph wide gap plus half a glyph per bucket)
+	minimapWidth = showMinimap ? (minimapBuckets * 0.5f + 1.0f) * glyphSize.x : 0.0f;
+
 	// get current position and total/visible editor size
 	auto pos = ImGui::GetCursorPos();
-	auto totalSize = ImVec2(textOffset + document.getMaxColumn() * glyphSize.x + cursorWidth, document.size() * glyphSize.y);
+	auto totalSize = ImVec2(textOffset + document.getMaxColumn() * glyphSize.x + cursorWidth + minimapWidth, layout.getRowCount() * glyphSize.y);
 	auto visibleSize = ImGui::GetContentRegionAvail();
 
 	if (size.x > 0.0f) {
@@ -87,13 +108,28 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 		visibleSize.y = std::max(visibleSize.y + size.y, 0.0f);
 	}
 
+	// rewrap lines if the wrap width or tab size changed
+	// (the vertical scrollbar is always accounted for so it can't change the wrap width)
+	if (isWrapping()) {
+		auto width = std::max(static_cast<int>(std::floor((visibleSize.x - textOffset - ImGui::GetStyle().ScrollbarSize - cursorWidth - minimapWidth) / glyphSize.x)), 1);
+
+		if (width != wrapWidth || document.getTabSize() != wrapTabSize) {
+			wrapWidth = width;
+			wrapTabSize = document.getTabSize();
+			updateWordWrap();
+		}
+
+		// wrapped text doesn't scroll horizontally
+		totalSize = ImVec2(textOffset + wrapWidth * glyphSize.x + cursorWidth + minimapWidth, layout.getRowCount() * glyphSize.y);
+	}
+
 	// see if we have scrollbars
 	float scrollbarSize = ImGui::GetStyle().ScrollbarSize;
 	float verticalScrollBarSize = (totalSize.y > visibleSize.y) ? scrollbarSize : 0.0f;
 	float horizontalScrollBarSize = (totalSize.x > visibleSize.x) ? scrollbarSize : 0.0f;
 
 	// determine visible lines and columns
-	visibleWidth = visibleSize.x - textOffset - verticalScrollBarSize;
+	visibleWidth = visibleSize.x - textOffset - verticalScrollBarSize - minimapWidth;
 	visibleColumns = std::max(static_cast<int>(std::ceil(visibleWidth / glyphSize.x)), 0);
 	visibleHeight = visibleSize.y - horizontalScrollBarSize;
 	visibleLines = std::max(static_cast<int>(std::ceil(visibleHeight / glyphSize.y)), 0);
@@ -105,15 +141,20 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 	// ensure cursor is visible (if requested)
 	if (ensureCursorIsVisible) {
 		auto cursor = cursors.getCurrent().getInteractiveEnd();
+		layout.reveal(cursor.line);
+		auto row = layout.getRow(cursor.line) + getWrapRow(cursor.line, cursor.column);
 
-		if (cursor.line <= firstVisibleLine + 1) {
-			scrollY = std::max(0.0f, (cursor.line - 2.0f) * glyphSize.y);
+		if (row <= firstVisibleRow + 1) {
+			scrollY = std::max(0.0f, (row - 2.0f) * glyphSize.y);
 
-		} else if (cursor.line >= lastVisibleLine - 1) {
-			scrollY = std::max(0.0f, (cursor.line + 2.0f) * glyphSize.y - visibleHeight);
+		} else if (row >= lastVisibleRow - 1) {
+			scrollY = std::max(0.0f, (row + 2.0f) * glyphSize.y - visibleHeight);
 		}
 
-		if (cursor.column <= firstVisibleColumn + 1) {
+		if (isWrapping()) {
+			// nothing to do horizontally
+
+		} else if (cursor.column <= firstVisibleColumn + 1) {
 			scrollX = std::max(0.0f, (cursor.column - 2.0f) * glyphSize.x);
 
 		} else if (cursor.column >= lastVisibleColumn - 1) {
@@ -128,17 +169,21 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 		scrollToLineNumber = std::min(scrollToLineNumber, document.lineCount());
 		scrollX = 0.0f;
 
+		// make sure the line isn't folded away
+		layout.reveal(scrollToLineNumber);
+		auto row = layout.getRow(scrollToLineNumber);
+
 		switch (scrollToAlignment) {
 			case Scroll::alignTop:
-				scrollY = std::max(0.0f, static_cast<float>(scrollToLineNumber) * glyphSize.y);
+				scrollY = std::max(0.0f, static_cast<float>(row) * glyphSize.y);
 				break;
 
 			case Scroll::alignMiddle:
-				scrollY = std::max(0.0f, static_cast<float>(scrollToLineNumber - visibleLines / 2) * glyphSize.y);
+				scrollY = std::max(0.0f, static_cast<float>(row - visibleLines / 2) * glyphSize.y);
 				break;
 
 			case Scroll::alignBottom:
-				scrollY = std::max(0.0f, static_cast<float>(scrollToLineNumber - (visibleLines - 1)) * glyphSize.y);
+				scrollY = std::max(0.0f, static_cast<float>(row - (visibleLines - 1)) * glyphSize.y);
 				break;
 		}
 
@@ -189,21 +234,51 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 			colorizer.updateChangedLines(document, language);
 		}
 
-		if (showMatchingBrackets && (documentChanged || showMatchingBracketsChanged || languageChanged)) {
+		if ((showMatchingBrackets || folding) && !document.isLazy() && (documentChanged || showMatchingBracketsChanged || languageChanged || foldingChanged)) {
 			// rebuild bracket list
 			bracketeer.update(document);
 		}
 	}
 
+	// rebuild fold ranges (if required)
+	if (documentChanged || languageChanged || foldingChanged) {
+		if (folding && language && !document.isLazy()) {
+			layout.update(bracketeer, document.lineCount());
+
+		} else {
+			layout.reset(document.lineCount());
+		}
+	}
+
+	// update wrapped lines (if required)
+	if ((wordWrap || wordWrapChanged) && (documentChanged || languageChanged || foldingChanged || wordWrapChanged)) {
+		updateWordWrap();
+	}
+
+	// colors or lines changed, so the minimap has to be rebuilt
+	if (documentChanged || languageChanged || showMatchingBracketsChanged) {
+		minimapChanged = true;
+	}
+
 	// reset changed states
 	showMatchingBracketsChanged = false;
 	languageChanged = false;
+	foldingChanged = false;
+	wordWrapChanged = false;
 
 	// determine view parameters
 	firstVisibleColumn = std::max(static_cast<int>(std::floor(ImGui::GetScrollX() / glyphSize.x)), 0);
 	lastVisibleColumn = static_cast<int>(std::floor((ImGui::GetScrollX() + visibleWidth) / glyphSize.x));
-	firstVisibleLine = std::max(static_cast<int>(std::floor(ImGui::GetScrollY() / glyphSize.y)), 0);
-	lastVisibleLine = std::min(static_cast<int>(std::floor((ImGui::GetScrollY() + visibleHeight) / glyphSize.y)), document.lineCount() - 1);
+	auto lastRow = layout.getRowCount() - 1;
+	firstVisibleRow = std::min(std::max(static_cast<int>(std::floor(ImGui::GetScrollY() / glyphSize.y)), 0), lastRow);
+	lastVisibleRow = std::min(static_cast<int>(std::floor((ImGui::GetScrollY() + visibleHeight) / glyphSize.y)), lastRow);
+	firstVisibleLine = layout.getLine(firstVisibleRow);
+	lastVisibleLine = layout.getLine(lastVisibleRow);
+
+	// decode lines of large files that scrolled into view
+	if (document.isLazy()) {
+		decodeVisibleLines();
+	}
 
 	// render editor parts
 	renderSelections();
@@ -213,7 +288,9 @@ void TextEditor::render(const char* title, const ImVec2& size, bool border) {
 	renderCursors();
 	renderMargin();
 	renderLineNumbers();
+	renderFolds();
 	renderDecorations();
+	renderMinimap();
 
 	if (ImGui::BeginPopup("LineNumberContextMenu")) {
 		lineNumberContextMenuCallback(contextMenuLine);
@@ -252,12 +329,23 @@ void TextEditor::renderSelections() {
 				auto first = std::max(start.line, firstVisibleLine);
 				auto last = std::min(end.line, lastVisibleLine);
 
-				for (auto line = first; line <= last; line++) {
+				for (auto line = layout.isHidden(first) ? layout.getNextVisibleLine(first) : first; line <= last; line = layout.getNextVisibleLine(line)) {
 					auto x = cursorScreenPos.x + textOffset;
-					auto left = x + (line == first ? start.column : 0) * glyphSize.x;
-					auto right = x + (line == last ? end.column : document[line].maxColumn) * glyphSize.x;
-					auto y = cursorScreenPos.y + line * glyphSize.y;
-					drawList->AddRectFilled(ImVec2(left, y), ImVec2(right, y + glyphSize.y), palette.get(Color::selection));
+					auto y = cursorScreenPos.y + layout.getRow(line) * glyphSize.y;
+					auto left = (line == start.line) ? start.column : 0;
+					auto right = (line == end.line) ? end.column : document[line].maxColumn;
+
+					// a wrapped line can have a selection on each of its rows
+					for (int row = 0; row < layout.getRows(line); row++, y += glyphSize.y) {
+						auto rowStart = getWrapRowStart(line, row);
+						auto rowEnd = getWrapRowEnd(line, row);
+
+						if (left <= rowEnd && right >= rowStart) {
+							auto x1 = x + (std::max(left, rowStart) - rowStart) * glyphSize.x;
+							auto x2 = x + (std::min(right, rowEnd) - rowStart) * glyphSize.x;
+							drawList->AddRectFilled(ImVec2(x1, y), ImVec2(x2, y + glyphSize.y), palette.get(Color::selection));
+						}
+					}
 				}
 			}
 		}
@@ -274,10 +362,10 @@ void TextEditor::renderMarkers() {
 		auto drawList = ImGui::GetWindowDrawList();
 		ImVec2 cursorScreenPos = ImGui::GetCursorScreenPos();
 
-		for (int line = firstVisibleLine; line <= lastVisibleLine; line++) {
+		for (int line = firstVisibleLine; line <= lastVisibleLine; line = layout.getNextVisibleLine(line)) {
 			if (document[line].marker) {
 				auto& marker = markers[document[line].marker - 1];
-				auto y = cursorScreenPos.y + line * glyphSize.y;
+				auto y = cursorScreenPos.y + layout.getRow(line) * glyphSize.y;
 
 				if (((marker.lineNumberColor >> IM_COL32_A_SHIFT) & 0xFF) != 0) {
 					auto left = cursorScreenPos.x + lineNumberLeftOffset;
@@ -299,7 +387,7 @@ void TextEditor::renderMarkers() {
 					auto left = cursorScreenPos.x + textOffset;
 					auto right = left + lastVisibleColumn * glyphSize.x;
 					auto start = ImVec2(left, y);
-					auto end = ImVec2(right, y + glyphSize.y);
+					auto end = ImVec2(right, y + glyphSize.y * layout.getRows(line));
 					drawList->AddRectFilled(start, end, marker.textColor);
 
 					if (marker.textTooltip.size() && ImGui::IsMouseHoveringRect(start, end)) {
@@ -332,9 +420,11 @@ void TextEditor::renderMatchingBrackets() {
 					bracket.start.line <= lastVisibleLine &&
 					bracket.end.line > firstVisibleLine) {
 
-					auto lineX = cursorScreenPos.x + textOffset + std::min(bracket.start.column, bracket.end.column) * glyphSize.x;
-					auto startY = cursorScreenPos.y + (bracket.start.line + 1) * glyphSize.y;
-					auto endY = cursorScreenPos.y + bracket.end.line * glyphSize.y;
+					auto start = getTextPosition(bracket.start);
+					auto end = getTextPosition(bracket.end);
+					auto lineX = cursorScreenPos.x + textOffset + std::min(start.x, end.x);
+					auto startY = cursorScreenPos.y + start.y + glyphSize.y;
+					auto endY = cursorScreenPos.y + end.y;
 					drawList->AddLine(ImVec2(lineX, startY), ImVec2(lineX, endY), palette.get(Color::whitespace), 1.0f);
 				}
 			}
@@ -346,15 +436,17 @@ void TextEditor::renderMatchingBrackets() {
 				active->start.line <= lastVisibleLine &&
 				active->end.line > firstVisibleLine) {
 
-				auto x1 = cursorScreenPos.x + textOffset + active->start.column * glyphSize.x;
-				auto y1 = cursorScreenPos.y + active->start.line * glyphSize.y;
+				auto start = getTextPosition(active->start);
+				auto x1 = cursorScreenPos.x + textOffset + start.x;
+				auto y1 = cursorScreenPos.y + start.y;
 				drawList->AddRectFilled(ImVec2(x1, y1), ImVec2(x1 + glyphSize.x, y1 + glyphSize.y), palette.get(Color::matchingBracketBackground));
 
-				auto x2 = cursorScreenPos.x + textOffset + active->end.column * glyphSize.x;
-				auto y2 = cursorScreenPos.y + active->end.line * glyphSize.y;
+				auto end = getTextPosition(active->end);
+				auto x2 = cursorScreenPos.x + textOffset + end.x;
+				auto y2 = cursorScreenPos.y + end.y;
 				drawList->AddRectFilled(ImVec2(x2, y2), ImVec2(x2 + glyphSize.x, y2 + glyphSize.y), palette.get(Color::matchingBracketBackground));
 
-				if (active->end.line - active->start.line > 1) {
+				if (y2 - y1 > glyphSize.y) {
 					auto lineX = std::min(x1, x2);
 					drawList->AddLine(ImVec2(lineX, y1 + glyphSize.y), ImVec2(lineX, y2), palette.get(Color::matchingBracketActive), 1.0f);
 				}
@@ -371,22 +463,31 @@ void TextEditor::renderMatchingBrackets() {
 void TextEditor::renderText() {
 	auto drawList = ImGui::GetWindowDrawList();
 	ImVec2 cursorScreenPos = ImGui::GetCursorScreenPos();
-	ImVec2 lineScreenPos = cursorScreenPos + ImVec2(textOffset, firstVisibleLine * glyphSize.y);
 	auto tabSize = document.getTabSize();
 	auto firstRenderableColumn = (firstVisibleColumn / tabSize) * tabSize;
 
-	for (int i = firstVisibleLine; i <= lastVisibleLine; i++) {
+	for (int i = firstVisibleLine; i <= lastVisibleLine; i = layout.getNextVisibleLine(i)) {
 		auto& line = document[i];
+		ImVec2 lineScreenPos = cursorScreenPos + ImVec2(textOffset, layout.getRow(i) * glyphSize.y);
+		auto& wrapColumns = getWrapColumns(i);
+		auto nextWrap = wrapColumns.begin();
+		auto rowStart = 0;
 
 		// draw colored glyphs for current line
-		auto column = firstRenderableColumn;
+		auto column = isWrapping() ? 0 : firstRenderableColumn;
 		auto index = document.getIndex(line, column);
 		auto lineSize = line.size();
 
-		while (index < lineSize && column <= lastVisibleColumn) {
+		while (index < lineSize && (isWrapping() || column <= lastVisibleColumn)) {
+			// move to the next row if the line wraps here
+			if (nextWrap != wrapColumns.end() && column >= *nextWrap) {
+				rowStart = *nextWrap++;
+				lineScreenPos.y += glyphSize.y;
+			}
+
 			auto& glyph = line[index];
 			auto codepoint = glyph.codepoint;
-			ImVec2 glyphPos{lineScreenPos.x + column * glyphSize.x, lineScreenPos.y};
+			ImVec2 glyphPos{lineScreenPos.x + (column - rowStart) * glyphSize.x, lineScreenPos.y};
 
 			if (codepoint == '\t') {
 				if (showWhitespaces) {
@@ -420,8 +521,329 @@ void TextEditor::renderText() {
 			column += (codepoint == '\t') ? tabSize - (column % tabSize) : 1;
 		}
 
-		lineScreenPos.y += glyphSize.y;
+		// draw folded text indicator (if required)
+		auto endColumn = line.maxColumn - rowStart + 1;
+
+		if (layout.isFolded(i)) {
+			ImVec2 start{lineScreenPos.x + endColumn * glyphSize.x, lineScreenPos.y};
+			ImVec2 end{start.x + 3 * glyphSize.x, start.y + glyphSize.y};
+			drawList->AddRect(start, end, palette.get(Color::whitespace));
+			drawList->AddText(font, fontSize, start, palette.get(Color::whitespace), "...");
+			endColumn += 4;
+		}
+
+		// draw end-of-line annotation (if required)
+		if (annotatorCallback) {
+			auto annotation = annotatorCallback(i);
+
+			if (annotation.size()) {
+				ImVec2 annotationPos{lineScreenPos.x + (endColumn + 1) * glyphSize.x, lineScreenPos.y};
+				drawList->AddText(font, fontSize, annotationPos, palette.get(Color::comment), annotation.data(), annotation.data() + annotation.size());
+			}
+		}
+	}
+}
+
+
+//
+//	TextEditor::decodeVisibleLines
+//
+
+void TextEditor::decodeVisibleLines() {
+	auto decoded = false;
+
+	for (int line = firstVisibleLine; line <= lastVisibleLine; line++) {
+		auto entry = decodedLineIndex.find(line);
+
+		if (entry != decodedLineIndex.end()) {
+			// mark as most recently used
+			decodedLines.splice(decodedLines.begin(), decodedLines, entry->second);
+
+		} else {
+			document.decodeLine(line);
+			decodedLines.push_front(line);
+			decodedLineIndex[line] = decodedLines.begin();
+			decoded = true;
+		}
+	}
+
+	// release least recently used lines
+	while (decodedLines.size() > decodedLineLimit) {
+		document.releaseLine(decodedLines.back());
+		decodedLineIndex.erase(decodedLines.back());
+		decodedLines.pop_back();
+	}
+
+	if (decoded) {
+		// colorize new lines (top to bottom so states carry over)
+		// note: the first line starts in the state left behind by the line above it, which is only
+		// known if that line has been colorized before (i.e. comments or strings that start above
+		// a region that is jumped to are not recognized until the lines above are shown)
+		if (language) {
+			colorizer.updateChangedLines(document, language, firstVisibleLine, lastVisibleLine);
+		}
+
+		minimapChanged = true;
+	}
+}
+
+
+//
+//	TextEditor::updateWordWrap
+//
+
+void TextEditor::updateWordWrap() {
+	for (int i = 0; i < document.lineCount(); i++) {
+		auto& line = document[i];
+
+		// lines that fit don't have to be wrapped
+		if (isWrapping() && line.maxColumn > wrapWidth) {
+			wrapLine(line);
+			layout.setRows(i, static_cast<int>(line.wrapColumns.size()) + 1);
+
+		} else {
+			layout.setRows(i, 1);
+		}
+	}
+}
+
+
+//
+//	TextEditor::wrapLine
+//
+
+void TextEditor::wrapLine(Line& line) {
+	// see if cached wrap is still valid
+	if (line.wrapVersion == line.version && line.wrapWidth == wrapWidth && line.wrapTabSize == wrapTabSize) {
+		return;
+	}
+
+	line.wrapColumns.clear();
+	int column = 0;
+	int rowStart = 0;
+	int wordStart = 0;
+
+	for (auto& glyph : line) {
+		auto width = (glyph.codepoint == '\t') ? wrapTabSize - (column % wrapTabSize) : 1;
+
+		if (column > rowStart && column + width > rowStart + wrapWidth) {
+			// wrap at the start of the current word (or in the middle of it if it doesn't fit on a row)
+			rowStart = (wordStart > rowStart && column + width <= wordStart + wrapWidth) ? wordStart : column;
+			line.wrapColumns.emplace_back(rowStart);
+		}
+
+		column += width;
+
+		if (CodePoint::isWhiteSpace(glyph.codepoint)) {
+			wordStart = column;
+		}
+	}
+
+	line.wrapVersion = line.version;
+	line.wrapWidth = wrapWidth;
+	line.wrapTabSize = wrapTabSize;
+}
+
+
+//
+//	TextEditor::getWrapColumns
+//
+
+const std::vector<int>& TextEditor::getWrapColumns(int line) const {
+	static const std::vector<int> none;
+
+	if (isWrapping() && line >= 0 && line < document.lineCount()) {
+		auto& glyphs = document[line];
+
+		if (glyphs.wrapVersion == glyphs.version && glyphs.wrapWidth == wrapWidth && glyphs.wrapTabSize == wrapTabSize) {
+			return glyphs.wrapColumns;
+		}
+	}
+
+	return none;
+}
+
+
+//
+//	TextEditor::getWrapRow
+//
+
+int TextEditor::getWrapRow(int line, int column) const {
+	auto& columns = getWrapColumns(line);
+	return static_cast<int>(std::upper_bound(columns.begin(), columns.end(), column) - columns.begin());
+}
+
+
+//
+//	TextEditor::getWrapRowStart
+//
+
+int TextEditor::getWrapRowStart(int line, int row) const {
+	auto& columns = getWrapColumns(line);
+	return (row > 0 && row <= static_cast<int>(columns.size())) ? columns[row - 1] : 0;
+}
+
+
+//
+//	TextEditor::getWrapRowEnd
+//
+
+int TextEditor::getWrapRowEnd(int line, int row) const {
+	auto& columns = getWrapColumns(line);
+
+	if (row >= 0 && row < static_cast<int>(columns.size())) {
+		return columns[row];
+
+	} else if (line >= 0 && line < document.lineCount()) {
+		return document[line].maxColumn;
+
+	} else {
+		return 0;
+	}
+}
+
+
+//
+//	TextEditor::getTextPosition
+//
+
+ImVec2 TextEditor::getTextPosition(Coordinate coordinate) const {
+	// get the position of a coordinate relative to the start of the text
+	auto row = getWrapRow(coordinate.line, coordinate.column);
+
+	return ImVec2(
+		(coordinate.column - getWrapRowStart(coordinate.line, row)) * glyphSize.x,
+		(layout.getRow(coordinate.line) + row) * glyphSize.y);
+}
+
+
+//
+//	TextEditor::getMouseCoordinate
+//
+
+TextEditor::Coordinate TextEditor::getMouseCoordinate(int row, float x, bool glyph) const {
+	// translate a visible row and horizontal text offset into a (non-normalized) coordinate
+	auto offset = static_cast<int>(glyph ? std::floor(x / glyphSize.x) : std::round(x / glyphSize.x));
+
+	if (row >= layout.getRowCount()) {
+		return Coordinate(document.lineCount() + row - layout.getRowCount(), offset);
+	}
+
+	row = std::max(row, 0);
+	auto line = layout.getLine(row);
+	auto wrapRow = row - layout.getRow(line);
+	auto column = getWrapRowStart(line, wrapRow) + offset;
+
+	// don't run into the next row of a wrapped line
+	if (wrapRow < static_cast<int>(getWrapColumns(line).size())) {
+		auto rowEnd = getWrapRowEnd(line, wrapRow);
+
+		if (column >= rowEnd) {
+			column = glyph ? document[line].maxColumn : rowEnd;
+		}
+	}
+
+	return Coordinate(line, column);
+}
+
+
+//
+//	TextEditor::getLineIdentifiers
+//
+
+void TextEditor::getLineIdentifiers(int line, std::vector<std::string>& identifiers) const {
+	identifiers.clear();
+
+	if (line < 0 || line >= document.lineCount()) {
+		return;
+	}
+
+	auto& glyphs = document[line];
+	auto isIdentifier = [](const Glyph& glyph) { return glyph.color == Color::identifier || glyph.color == Color::knownIdentifier; };
+
+	for (size_t i = 0; i < glyphs.size();) {
+		if (!isIdentifier(glyphs[i])) {
+			i++;
+			continue;
+		}
+
+		// find the end of the identifier
+		auto start = i;
+
+		while (i < glyphs.size() && isIdentifier(glyphs[i])) {
+			i++;
+		}
+
+		// skip members
+		if (start > 0 && glyphs[start - 1].codepoint == '.') {
+			continue;
+		}
+
+		std::string identifier;
+		char utf8[4];
+
+		for (auto j = start; j < i; j++) {
+			identifier.append(utf8, CodePoint::write(utf8, glyphs[j].codepoint));
+		}
+
+		identifiers.emplace_back(std::move(identifier));
+	}
+}
+
+
+//
+//	TextEditor::getExpressionAt
+//
+
+std::string TextEditor::getExpressionAt(int line, int column) const {
+	if (line < 0 || line >= document.lineCount()) {
+		return std::string();
+	}
+
+	auto& glyphs = document[line];
+	auto index = document.getIndex(glyphs, column);
+
+	auto isCode = [](const Glyph& glyph) { return glyph.color != Color::comment && glyph.color != Color::string && glyph.color != Color::number; };
+	auto isWord = [&](size_t i) { return isCode(glyphs[i]) && CodePoint::isWord(glyphs[i].codepoint); };
+
+	if (index >= glyphs.size() || !isWord(index)) {
+		return std::string();
+	}
+
+	// find the end of the hovered word
+	auto end = index;
+
+	while (end < glyphs.size() && isWord(end)) {
+		end++;
+	}
+
+	// walk back over words and member/scope separators
+	auto start = index;
+
+	while (start > 0) {
+		auto& previous = glyphs[start - 1];
+
+		if (isWord(start - 1) || (isCode(previous) && (previous.codepoint == '.' || previous.codepoint == ':'))) {
+			start--;
+
+		} else {
+			break;
+		}
+	}
+
+	// don't start with a separator
+	while (start < index && !isWord(start)) {
+		start++;
+	}
+
+	std::string expression;
+	char utf8[4];
+
+	for (auto i = start; i < end; i++) {
+		expression.append(utf8, CodePoint::write(utf8, glyphs[i].codepoint));
 	}
+
+	return expression;
 }
 
 
@@ -442,9 +864,10 @@ void TextEditor::renderCursors() {
 			for (auto& cursor : cursors) {
 				auto pos = cursor.getInteractiveEnd();
 
-				if (pos.line >= firstVisibleLine && pos.line <= lastVisibleLine) {
-					auto x = cursorScreenPos.x + textOffset + pos.column * glyphSize.x - 1;
-					auto y = cursorScreenPos.y + pos.line * glyphSize.y;
+				if (pos.line >= firstVisibleLine && pos.line <= lastVisibleLine && !layout.isHidden(pos.line)) {
+					auto position = getTextPosition(pos);
+					auto x = cursorScreenPos.x + textOffset + position.x - 1;
+					auto y = cursorScreenPos.y + position.y;
 					drawList->AddRectFilled(ImVec2(x, y), ImVec2(x + cursorWidth, y + glyphSize.y), palette.get(Color::cursor));
 				}
 			}
@@ -455,8 +878,9 @@ void TextEditor::renderCursors() {
 		// text input events unless we do this
 		if (!readOnly && ImGui::GetPlatformIO().Platform_SetImeDataFn) {
 			auto pos = cursors.getCurrent().getInteractiveEnd();
-			auto x = cursorScreenPos.x + textOffset + pos.column * glyphSize.x - 1;
-			auto y = cursorScreenPos.y + pos.line * glyphSize.y;
+			auto position = getTextPosition(pos);
+			auto x = cursorScreenPos.x + textOffset + position.x - 1;
+			auto y = cursorScreenPos.y + position.y;
 
 			ImGuiPlatformImeData data;
 			data.WantVisible = true;
@@ -496,11 +920,41 @@ void TextEditor::renderLineNumbers() {
 		auto curserLine = cursors.getCurrent().getInteractiveEnd().line;
 		auto position = ImVec2(ImGui::GetWindowPos().x + lineNumberRightOffset, cursorScreenPos.y);
 
-		for (int i = firstVisibleLine; i <= lastVisibleLine; i++) {
+		for (int i = firstVisibleLine; i <= lastVisibleLine; i = layout.getNextVisibleLine(i)) {
 			auto width = static_cast<int>(std::log10(i + 1) + 1.0f) * glyphSize.x;
 			auto foreground = (i == curserLine) ? Color::currentLineNumber : Color::lineNumber;
 			auto number = std::to_string(i + 1);
-			drawList->AddText(position + ImVec2(-width, i * glyphSize.y), palette.get(foreground), number.c_str());
+			drawList->AddText(position + ImVec2(-width, layout.getRow(i) * glyphSize.y), palette.get(foreground), number.c_str());
+		}
+	}
+}
+
+
+//
+//	TextEditor::renderFolds
+//
+
+void TextEditor::renderFolds() {
+	if (folding) {
+		auto drawList = ImGui::GetWindowDrawList();
+		auto cursorScreenPos = ImGui::GetCursorScreenPos();
+		auto x = ImGui::GetWindowPos().x + foldOffset;
+		auto size = glyphSize.x * 0.8f;
+		auto color = palette.get(Color::lineNumber);
+
+		for (int i = firstVisibleLine; i <= lastVisibleLine; i = layout.getNextVisibleLine(i)) {
+			if (layout.isFoldable(i)) {
+				auto y = cursorScreenPos.y + layout.getRow(i) * glyphSize.y + (glyphSize.y - size) * 0.5f;
+
+				if (layout.isFolded(i)) {
+					// pointing right
+					drawList->AddTriangleFilled(ImVec2(x, y), ImVec2(x + size, y + size * 0.5f), ImVec2(x, y + size), color);
+
+				} else {
+					// pointing down
+					drawList->AddTriangleFilled(ImVec2(x, y), ImVec2(x + size, y), ImVec2(x + size * 0.5f, y + size), color);
+				}
+			}
 		}
 	}
 }
@@ -513,16 +967,14 @@ void TextEditor::renderLineNumbers() {
 void TextEditor::renderDecorations() {
 	if (decoratorWidth > 0.0f && decoratorCallback) {
 		auto cursorScreenPos = ImGui::GetCursorScreenPos();
-		auto position = ImVec2(ImGui::GetWindowPos().x + decorationOffset, cursorScreenPos.y + glyphSize.y * firstVisibleLine);
 		Decorator decorator{0, decoratorWidth, glyphSize.y};
 
-		for (int i = firstVisibleLine; i <= lastVisibleLine; i++) {
+		for (int i = firstVisibleLine; i <= lastVisibleLine; i = layout.getNextVisibleLine(i)) {
 			decorator.line = i;
-			ImGui::SetCursorScreenPos(position);
+			ImGui::SetCursorScreenPos(ImVec2(ImGui::GetWindowPos().x + decorationOffset, cursorScreenPos.y + glyphSize.y * layout.getRow(i)));
 			ImGui::PushID(i);
 			decoratorCallback(decorator);
 			ImGui::PopID();
-			position.y += glyphSize.y;
 		}
 
 		ImGui::SetCursorScreenPos(cursorScreenPos);
@@ -531,58 +983,202 @@ void TextEditor::renderDecorations() {
 
 
 //
-//	latchButton
+//	TextEditor::renderMinimap
 //
 
-static bool latchButton(const char* label, bool* value, const ImVec2& size) {
-	bool changed = false;
-	ImVec4* colors = ImGui::GetStyle().Colors;
+void TextEditor::renderMinimap() {
+	if (!showMinimap) {
+		return;
+	}
 
-	if (*value) {
-		ImGui::PushStyleColor(ImGuiCol_Button, colors[ImGuiCol_ButtonActive]);
-		ImGui::PushStyleColor(ImGuiCol_ButtonHovered, colors[ImGuiCol_ButtonActive]);
-		ImGui::PushStyleColor(ImGuiCol_ButtonActive, colors[ImGuiCol_TableBorderLight]);
+	// the minimap shows the whole document, so lines are sampled if there are more lines than pixel rows
+	auto drawList = ImGui::GetWindowDrawList();
+	auto windowPos = ImGui::GetWindowPos();
+	auto left = windowPos.x + textOffset + visibleWidth;
+	auto top = windowPos.y;
+	auto right = left + minimapWidth;
+	auto bottom = top + visibleHeight;
+	auto bucketWidth = glyphSize.x * 0.5f;
+	auto rowHeight = std::max(std::floor(glyphSize.y * 0.125f), 1.0f);
+	auto lineCount = document.lineCount();
+	auto rows = std::min(lineCount, static_cast<int>(visibleHeight / rowHeight));
+	drawList->AddRectFilled(ImVec2(left, top), ImVec2(right, bottom), palette.get(Color::background));
+
+	if (rows <= 0) {
+		return;
+	}
+
+	// rebuild cached rectangles (if required)
+	if (minimapChanged || rows != minimapRows) {
+		minimapRects.clear();
+
+		for (int row = 0; row < rows; row++) {
+			auto& line = document[static_cast<int>(static_cast<int64_t>(row) * lineCount / rows)];
+
+			if (line.updateMinimap) {
+				summarizeLine(line);
+			}
 
-	} else {
-		ImGui::PushStyleColor(ImGuiCol_Button, colors[ImGuiCol_TableBorderLight]);
-		ImGui::PushStyleColor(ImGuiCol_ButtonHovered, colors[ImGuiCol_TableBorderLight]);
-		ImGui::PushStyleColor(ImGuiCol_ButtonActive, colors[ImGuiCol_ButtonActive]);
-	}
+			// merge adjacent buckets of the same color
+			for (int bucket = 0; bucket < minimapBuckets;) {
+				auto color = line.minimap[bucket];
+				auto first = bucket;
 
-	ImGui::Button(label, size);
+				while (bucket < minimapBuckets && line.minimap[bucket] == color) {
+					bucket++;
+				}
 
-	if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
-		*value = !*value;
-		changed = true;
-	}
+				if (color != Color::background) {
+					minimapRects.push_back({row, first, bucket - 1, color});
+				}
+			}
+		}
 
-	ImGui::PopStyleColor(3);
-	return changed;
-}
+		minimapRows = rows;
+		minimapChanged = false;
+	}
 
+	// render document summary
+	left += glyphSize.x;
 
-//
-//	inputString
-//
+	for (auto& rect : minimapRects) {
+		auto y = top + rect.row * rowHeight;
+		drawList->AddRectFilled(
+			ImVec2(left + rect.firstBucket * bucketWidth, y),
+			ImVec2(left + (rect.lastBucket + 1) * bucketWidth, y + rowHeight),
+			palette.get(rect.color));
+	}
 
-static bool inputString(const char* label, std::string* value, ImGuiInputTextFlags flags=ImGuiInputTextFlags_None) {
-	flags |=
-		ImGuiInputTextFlags_NoUndoRedo |
-		ImGuiInputTextFlags_CallbackResize;
+	// render lines of interest on top
+	auto scale = rows * rowHeight / lineCount;
 
-	return ImGui::InputText(label, (char*) value->c_str(), value->capacity() + 1, flags, [](ImGuiInputTextCallbackData* data) {
-		if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
-			std::string* value = (std::string*) data->UserData;
-			value->resize(data->BufTextLen);
-			data->Buf = (char*) value->c_str();
+	auto highlight = [&](int line, ImU32 color) {
+		if (line >= 0 && line < lineCount) {
+			auto y = top + std::floor(line * scale);
+			drawList->AddRectFilled(ImVec2(left, y), ImVec2(right, y + rowHeight), color);
 		}
+	};
 
-		return 0;
-	}, value);
-}
+	for (auto& marker : markers) {
+		highlight(marker.line, ((marker.textColor >> IM_COL32_A_SHIFT) & 0xFF) ? marker.textColor : marker.lineNumberColor);
+	}
 
+	for (auto& [line, color] : minimapHighlights) {
+		highlight(line, color);
+	}
 
-//
+	for (auto& cursor : cursors) {
+		highlight(cursor.getInteractiveEnd().line, palette.get(Color::cursor));
+	}
+
+	// render visible part of the document
+	auto viewTop = top + firstVisibleLine * scale;
+	auto viewBottom = top + (lastVisibleLine + 1) * scale;
+	drawList->AddRectFilled(ImVec2(left, viewTop), ImVec2(right, viewBottom), palette.get(Color::selection));
+
+	// scroll when the minimap is clicked or dragged
+	if (ImGui::IsWindowHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left) && ImGui::IsMouseHoveringRect(ImVec2(left, top), ImVec2(right, bottom))) {
+		minimapDragging = true;
+
+	} else if (!ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
+		minimapDragging = false;
+	}
+
+	if (minimapDragging) {
+		auto line = std::min(std::max(static_cast<int>((ImGui::GetMousePos().y - top) / scale), 0), lineCount - 1);
+		ImGui::SetScrollY(std::max(layout.getRow(line) * glyphSize.y - visibleHeight * 0.5f, 0.0f));
+	}
+}
+
+
+//
+//	TextEditor::summarizeLine
+//
+
+void TextEditor::summarizeLine(Line& line) {
+	// find the most common non-whitespace color in each bucket of columns
+	std::array<int, static_cast<size_t>(Color::count)> counts;
+	auto tabSize = document.getTabSize();
+	auto glyph = line.begin();
+	int column = 0;
+
+	for (int bucket = 0; bucket < minimapBuckets; bucket++) {
+		auto end = (bucket + 1) * minimapColumns;
+		auto dominant = Color::background;
+		counts.fill(0);
+
+		for (; glyph < line.end() && column < end; glyph++) {
+			if (!CodePoint::isWhiteSpace(glyph->codepoint)) {
+				auto count = ++counts[static_cast<size_t>(glyph->color)];
+
+				if (dominant == Color::background || count > counts[static_cast<size_t>(dominant)]) {
+					dominant = glyph->color;
+				}
+			}
+
+			column = (glyph->codepoint == '\t') ? ((column / tabSize) + 1) * tabSize : column + 1;
+		}
+
+		line.minimap[bucket] = dominant;
+	}
+
+	line.updateMinimap = false;
+}
+
+
+//
+//	latchButton
+//
+
+static bool latchButton(const char* label, bool* value, const ImVec2& size) {
+	bool changed = false;
+	ImVec4* colors = ImGui::GetStyle().Colors;
+
+	if (*value) {
+		ImGui::PushStyleColor(ImGuiCol_Button, colors[ImGuiCol_ButtonActive]);
+		ImGui::PushStyleColor(ImGuiCol_ButtonHovered, colors[ImGuiCol_ButtonActive]);
+		ImGui::PushStyleColor(ImGuiCol_ButtonActive, colors[ImGuiCol_TableBorderLight]);
+
+	} else {
+		ImGui::PushStyleColor(ImGuiCol_Button, colors[ImGuiCol_TableBorderLight]);
+		ImGui::PushStyleColor(ImGuiCol_ButtonHovered, colors[ImGuiCol_TableBorderLight]);
+		ImGui::PushStyleColor(ImGuiCol_ButtonActive, colors[ImGuiCol_ButtonActive]);
+	}
+
+	ImGui::Button(label, size);
+
+	if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
+		*value = !*value;
+		changed = true;
+	}
+
+	ImGui::PopStyleColor(3);
+	return changed;
+}
+
+
+//
+//	inputString
+//
+
+static bool inputString(const char* label, std::string* value, ImGuiInputTextFlags flags=ImGuiInputTextFlags_None) {
+	flags |=
+		ImGuiInputTextFlags_NoUndoRedo |
+		ImGuiInputTextFlags_CallbackResize;
+
+	return ImGui::InputText(label, (char*) value->c_str(), value->capacity() + 1, flags, [](ImGuiInputTextCallbackData* data) {
+		if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+			std::string* value = (std::string*) data->UserData;
+			value->resize(data->BufTextLen);
+			data->Buf = (char*) value->c_str();
+		}
+
+		return 0;
+	}, value);
+}
+
+
+//
 //	TextEditor::renderFindReplace
 //
 
@@ -829,17 +1425,35 @@ void TextEditor::handleKeyboardInputs() {
 //
 
 void TextEditor::handleMouseInteractions() {
-	// ignore interactions when the editor is not hovered
-	if (ImGui::IsWindowHovered()) {
+	hoverReady = false;
+
+	// ignore interactions when the editor is not hovered (the minimap handles its own)
+	auto overMinimap = showMinimap && ImGui::GetMousePos().x - ImGui::GetWindowPos().x >= textOffset + visibleWidth;
+
+	if (ImGui::IsWindowHovered() && !overMinimap && !minimapDragging) {
 		auto io = ImGui::GetIO();
 		ImVec2 mousePos = ImGui::GetMousePos() - ImGui::GetCursorScreenPos();
 		ImVec2 absoluteMousePos = ImGui::GetMousePos() - ImGui::GetWindowPos();
 		bool overLineNumbers = showLineNumbers && absoluteMousePos.x > lineNumberLeftOffset && absoluteMousePos.x < lineNumberRightOffset;
 		bool overText = mousePos.x - ImGui::GetScrollX() > textOffset;
+		bool overFolds = folding && absoluteMousePos.x > foldOffset && absoluteMousePos.x < foldOffset + glyphSize.x;
+
+		auto mouseRow = static_cast<int>(std::floor(mousePos.y / glyphSize.y));
+		auto mouseCoord = document.normalizeCoordinate(getMouseCoordinate(mouseRow, mousePos.x - textOffset, false));
+
+		// track the glyph the mouse is resting on (as opposed to the cursor location between glyphs)
+		auto glyphCoord = getMouseCoordinate(mouseRow, mousePos.x - textOffset, true);
 
-		auto mouseCoord = document.normalizeCoordinate(Coordinate(
-			static_cast<int>(std::floor(mousePos.y / glyphSize.y)),
-			static_cast<int>(std::round((mousePos.x - textOffset) / glyphSize.x))));
+		if (!overText || glyphCoord.line < 0 || glyphCoord.line >= document.lineCount() || glyphCoord.column >= document[glyphCoord.line].maxColumn || ImGui::IsAnyMouseDown()) {
+			hoverLocation = Coordinate::invalid();
+
+		} else if (glyphCoord != hoverLocation) {
+			hoverLocation = glyphCoord;
+			hoverStartTime = static_cast<float>(ImGui::GetTime());
+
+		} else {
+			hoverReady = static_cast<float>(ImGui::GetTime()) - hoverStartTime >= hoverDelay;
+		}
 
 		// show text cursor if required
 		if (ImGui::IsWindowFocused() && overText) {
@@ -908,6 +1522,12 @@ void TextEditor::handleMouseInteractions() {
 					cursors.updateCurrentCursor(start, end);
 				}
 
+			} else if (click && overFolds) {
+				// toggle fold
+				if (mouseRow >= 0 && mouseRow < layout.getRowCount() && layout.getRow(layout.getLine(mouseRow)) == mouseRow) {
+					layout.toggle(layout.getLine(mouseRow));
+				}
+
 			} else if (click) {
 				// left mouse button single click
 				auto extendCursor = ImGui::IsKeyDown(ImGuiMod_Shift);
@@ -1316,8 +1936,9 @@ void TextEditor::replaceAll() {
 
 void TextEditor::addMarker(int line, ImU32 lineNumberColor, ImU32 textColor, const std::string_view& lineNumberTooltip, const std::string_view& textTooltip) {
 	if (line >= 0 && line < document.lineCount()) {
-		markers.emplace_back(lineNumberColor, textColor, lineNumberTooltip, textTooltip);
+		markers.emplace_back(line, lineNumberColor, textColor, lineNumberTooltip, textTooltip);
 		document[line].marker = markers.size();
+		minimapChanged = true;
 	}
 }
 
@@ -1332,6 +1953,7 @@ void TextEditor::clearMarkers() {
 	}
 
 	markers.clear();
+	minimapChanged = true;
 }
 
 
@@ -1537,6 +2159,22 @@ void TextEditor::handleCharacter(ImWchar character) {
 void TextEditor::handleBackspace(bool wordMode) {
 	auto transaction = startTransaction();
 
+	// with multiple cursors, remove everything in a single sweep (unless the sections overlap)
+	if (cursors.hasMultiple()) {
+		std::vector<Document::Replacement> sections;
+		sections.reserve(cursors.size());
+
+		for (auto& cursor : cursors) {
+			auto start = cursor.hasSelection() ? cursor.getSelectionStart() : document.getLeft(cursor.getSelectionStart(), wordMode);
+			sections.emplace_back(Document::Replacement{start, cursor.getSelectionEnd(), start});
+		}
+
+		if (replaceTextInAllCursors(transaction, std::string_view(), &sections)) {
+			endTransaction(transaction);
+			return;
+		}
+	}
+
 	// remove selections or characters to the left of the cursor
 	for (auto cursor = cursors.begin(); cursor < cursors.end(); cursor++) {
 		auto start = cursor->hasSelection() ? cursor->getSelectionStart() : document.getLeft(cursor->getSelectionStart(), wordMode);
@@ -1557,6 +2195,23 @@ void TextEditor::handleBackspace(bool wordMode) {
 void TextEditor::handleDelete(bool wordMode) {
 	auto transaction = startTransaction();
 
+	// with multiple cursors, remove everything in a single sweep (unless the sections overlap)
+	if (cursors.hasMultiple()) {
+		std::vector<Document::Replacement> sections;
+		sections.reserve(cursors.size());
+
+		for (auto& cursor : cursors) {
+			auto start = cursor.getSelectionStart();
+			auto end = cursor.hasSelection() ? cursor.getSelectionEnd() : document.getRight(cursor.getSelectionEnd(), wordMode);
+			sections.emplace_back(Document::Replacement{start, end, start});
+		}
+
+		if (replaceTextInAllCursors(transaction, std::string_view(), &sections)) {
+			endTransaction(transaction);
+			return;
+		}
+	}
+
 	// remove selections or characters to the right of the cursor
 	for (auto cursor = cursors.begin(); cursor < cursors.end(); cursor++) {
 		auto start = cursor->getSelectionStart();
@@ -1895,7 +2550,8 @@ void TextEditor::selectionToUpperCase() {
 //
 
 void TextEditor::stripTrailingWhitespaces() {
-	auto transaction = startTransaction();
+	std::vector<int> lines;
+	std::vector<std::string> replacements;
 
 	// process all the lines
 	for (int i = 0; i < document.lineCount(); i++) {
@@ -1922,16 +2578,12 @@ void TextEditor::stripTrailingWhitespaces() {
 
 		// remove whitespaces (if required)
 		if (whitespace != std::numeric_limits<std::size_t>::max()) {
-			auto start = Coordinate(i, document.getColumn(line, whitespace));
-			auto end = Coordinate(i, document.getColumn(line, lineSize));
-			deleteText(transaction, start, end);
+			lines.emplace_back(i);
+			replacements.emplace_back(document.getSectionText(Coordinate(i, 0), Coordinate(i, document.getColumn(line, whitespace))));
 		}
 	}
 
-	// update cursor if transaction wasn't empty
-	if (endTransaction(transaction)) {
-		cursors.setCursor(document.normalizeCoordinate(cursors.getCurrent().getSelectionEnd()));
-	}
+	replaceLines(lines, replacements);
 }
 
 
@@ -1940,7 +2592,8 @@ void TextEditor::stripTrailingWhitespaces() {
 //
 
 void TextEditor::filterLines(std::function<std::string(std::string_view)> filter) {
-	auto transaction = startTransaction();
+	std::vector<int> lines;
+	std::vector<std::string> replacements;
 
 	// process all the lines
 	for (int i = 0; i < document.lineCount(); i++) {
@@ -1948,19 +2601,14 @@ void TextEditor::filterLines(std::function<std::string(std::string_view)> filter
 		auto before = document.getLineText(i);
 		std::string after = filter(before);
 
-		// update line if anything changed
+		// remember line if anything changed
 		if (after != before) {
-			auto start = Coordinate(i, 0);
-			auto end = document.getEndOfLine(start);
-			deleteText(transaction, start, end);
-			insertText(transaction, start, after);
+			lines.emplace_back(i);
+			replacements.emplace_back(std::move(after));
 		}
 	}
 
-	// update cursor if transaction wasn't empty
-	if (endTransaction(transaction)) {
-		cursors.setCursor(document.normalizeCoordinate(cursors.getCurrent().getSelectionEnd()));
-	}
+	replaceLines(lines, replacements);
 }
 
 
@@ -2044,6 +2692,50 @@ void TextEditor::spacesToTabs() {
 }
 
 
+//
+//	TextEditor::replaceLines
+//
+
+void TextEditor::replaceLines(const std::vector<int>& lines, const std::vector<std::string>& replacements) {
+	auto transaction = startTransaction();
+
+	// see if the new text splits lines
+	auto splitsLines = std::any_of(replacements.begin(), replacements.end(), [](const std::string& replacement) {
+		return replacement.find('\n') != std::string::npos;
+	});
+
+	if (splitsLines) {
+		// do it the slow way (from the bottom up so line numbers remain valid)
+		for (auto i = lines.size(); i-- > 0;) {
+			auto start = Coordinate(lines[i], 0);
+			auto end = document.getEndOfLine(start);
+			deleteText(transaction, start, end);
+			insertText(transaction, start, replacements[i]);
+		}
+
+	} else if (lines.size()) {
+		// replace all lines in place and record that as a single action
+		std::string before;
+		std::string after;
+
+		for (size_t i = 0; i < lines.size(); i++) {
+			before += document.getLineText(lines[i]);
+			before += '\n';
+			after += replacements[i];
+			after += '\n';
+		}
+
+		document.replaceLines(lines, after);
+		transaction->addReplaceLines(lines, before, after);
+	}
+
+	// update cursor if transaction wasn't empty
+	if (endTransaction(transaction)) {
+		cursors.setCursor(document.normalizeCoordinate(cursors.getCurrent().getSelectionEnd()));
+	}
+}
+
+
 //
 //	TextEditor::startTransaction
 //
@@ -2077,6 +2769,11 @@ bool TextEditor::endTransaction(std::shared_ptr<Transaction> transaction) {
 //
 
 void TextEditor::insertTextIntoAllCursors(std::shared_ptr<Transaction> transaction, const std::string_view& text) {
+	// multiple cursors are done in one go
+	if (replaceTextInAllCursors(transaction, text)) {
+		return;
+	}
+
 	// delete any selection content first
 	deleteTextFromAllCursors(transaction);
 
@@ -2095,6 +2792,10 @@ void TextEditor::insertTextIntoAllCursors(std::shared_ptr<Transaction> transacti
 //
 
 void TextEditor::deleteTextFromAllCursors(std::shared_ptr<Transaction> transaction) {
+	if (cursors.hasMultiple() && cursors.anyHasSelection() && replaceTextInAllCursors(transaction, std::string_view())) {
+		return;
+	}
+
 	for (auto cursor = cursors.begin(); cursor < cursors.end(); cursor++) {
 		if (cursor->hasSelection()) {
 			auto start = cursor->getSelectionStart();
@@ -2106,6 +2807,66 @@ void TextEditor::deleteTextFromAllCursors(std::shared_ptr<Transaction> transacti
 }
 
 
+//
+//	TextEditor::replaceTextInAllCursors
+//
+
+bool TextEditor::replaceTextInAllCursors(std::shared_ptr<Transaction> transaction, const std::string_view& text, const std::vector<Document::Replacement>* sections) {
+	// editing cursors one by one means shifting all the cursors that follow after every edit,
+	// so with many cursors, all edits are applied in a single sweep over the document instead
+	// (this requires the sections to be sorted without overlaps, which selections are after an update)
+	if (!cursors.hasMultiple()) {
+		return false;
+	}
+
+	std::vector<Document::Replacement> replacements;
+
+	if (sections) {
+		replacements = *sections;
+
+	} else {
+		replacements.reserve(cursors.size());
+
+		for (auto& cursor : cursors) {
+			replacements.emplace_back(Document::Replacement{cursor.getSelectionStart(), cursor.getSelectionEnd(), cursor.getSelectionStart()});
+		}
+	}
+
+	for (size_t i = 1; i < replacements.size(); i++) {
+		if (replacements[i - 1].end > replacements[i].start) {
+			return false;
+		}
+	}
+
+	std::vector<std::string> deletions;
+	deletions.reserve(replacements.size());
+
+	for (auto& replacement : replacements) {
+		deletions.emplace_back(replacement.start != replacement.end ? document.getSectionText(replacement.start, replacement.end) : std::string());
+	}
+
+	document.replaceSections(replacements, text);
+
+	// record the edits as if they were done one by one (so undo/redo can replay them)
+	for (size_t i = 0; i < replacements.size(); i++) {
+		auto& replacement = replacements[i];
+
+		if (!deletions[i].empty()) {
+			transaction->addDelete(replacement.start, replacement.end, deletions[i]);
+		}
+
+		if (!text.empty()) {
+			transaction->addInsert(replacement.start, replacement.insertEnd, text);
+		}
+
+		cursors[i].update(replacement.insertEnd, false);
+	}
+
+	makeCursorVisible();
+	return true;
+}
+
+
 //
 //	TextEditor::autoIndentAllCursors
 //
@@ -2546,6 +3307,9 @@ void TextEditor::Document::setText(const std::string_view& text) {
 	clear();
 	emplace_back();
 	updated = true;
+	lazy = false;
+	source.clear();
+	lineOffsets.clear();
 
 	// process input UTF-8 and generate lines of glyphs
 	auto end = text.end();
@@ -2568,6 +3332,94 @@ void TextEditor::Document::setText(const std::string_view& text) {
 }
 
 
+//
+//	TextEditor::Document::setLazyText
+//
+
+void TextEditor::Document::setLazyText(const std::string_view& text) {
+	// reset document
+	clear();
+	updated = true;
+	lazy = true;
+	source = text;
+	lineOffsets.clear();
+
+	// find the start of each line (memchr is vectorized by the C library)
+	const char* data = source.data();
+	const char* end = data + source.size();
+	const char* i = data + (CodePoint::skipBOM(text.begin(), text.end()) - text.begin());
+	lineOffsets.emplace_back(i - data);
+
+	while ((i = static_cast<const char*>(std::memchr(i, '\n', end - i))) != nullptr) {
+		lineOffsets.emplace_back(++i - data);
+	}
+
+	lineOffsets.emplace_back(source.size() + 1);
+
+	// create empty lines (using the byte count as an estimate of the line width)
+	resize(lineOffsets.size() - 1);
+	maxColumn = 0;
+
+	for (size_t line = 0; line < size(); line++) {
+		auto& glyphs = at(line);
+		glyphs.decoded = false;
+		glyphs.maxColumn = static_cast<int>(lineOffsets[line + 1] - lineOffsets[line] - 1);
+		maxColumn = std::max(maxColumn, glyphs.maxColumn);
+	}
+}
+
+
+//
+//	TextEditor::Document::decodeLine
+//
+
+bool TextEditor::Document::decodeLine(int line) {
+	if (!lazy || line < 0 || line >= lineCount() || at(line).decoded) {
+		return false;
+	}
+
+	// process the line's UTF-8 and generate glyphs
+	auto& glyphs = at(line);
+	std::string_view text(source);
+	auto i = text.begin() + lineOffsets[line];
+	auto end = text.begin() + (lineOffsets[line + 1] - 1);
+	int column = 0;
+
+	while (i < end) {
+		ImWchar character;
+		i = CodePoint::read(i, end, &character);
+
+		if (character != '\r') {
+			glyphs.emplace_back(Glyph(character, Color::text));
+			column = (character == '\t') ? ((column / tabSize) + 1) * tabSize : column + 1;
+		}
+	}
+
+	glyphs.maxColumn = column;
+	glyphs.decoded = true;
+	glyphs.colorize = true;
+	glyphs.updateMinimap = true;
+	glyphs.version++;
+	maxColumn = std::max(maxColumn, column);
+	return true;
+}
+
+
+//
+//	TextEditor::Document::releaseLine
+//
+
+void TextEditor::Document::releaseLine(int line) {
+	if (lazy && line >= 0 && line < lineCount() && at(line).decoded) {
+		auto& glyphs = at(line);
+		glyphs.clear();
+		glyphs.shrink_to_fit();
+		glyphs.decoded = false;
+		glyphs.updateMinimap = true;
+	}
+}
+
+
 //
 //	TextEditor::Document::insertText
 //
@@ -2660,42 +3512,272 @@ void TextEditor::Document::deleteText(Coordinate start, Coordinate end) {
 		at(line).colorize = true;
 	}
 
-	// update maximum column counts
-	updateMaximumColumn(start.line, end.line);
+	// update maximum column counts (only the start line survives a multi-line delete)
+	updateMaximumColumn(start.line, start.line);
 	updated = true;
 }
 
 
 //
-//	TextEditor::Document::getText
+//	TextEditor::Document::replaceLines
 //
 
-std::string TextEditor::Document::getText() const {
-	// process all glyphs and generate UTF-8 output
-	std::string text;
-	char utf8[4];
+void TextEditor::Document::replaceLines(const std::vector<int>& lines, const std::string_view& text) {
+	auto endOfText = text.end();
+	auto i = text.begin();
 
-	for (auto line = begin(); line < end(); line++) {
-		for (auto glyph = line->begin(); glyph < line->end(); glyph++) {
-			text.append(std::string_view(utf8, CodePoint::write(utf8, glyph->codepoint)));
-		}
+	for (auto lineNo : lines) {
+		auto& line = at(lineNo);
+		auto column = 0;
+		line.clear();
 
-		if (line < end() - 1) {
-			text += "\n";
-		}
-	}
+		// decode this line's text (up to the newline)
+		while (i < endOfText) {
+			ImWchar character;
+			i = CodePoint::read(i, endOfText, &character);
 
-	return text;
-}
+			if (character == '\n') {
+				break;
 
+			} else if (character != '\r') {
+				line.emplace_back(character, Color::text);
+				column = (character == '\t') ? ((column / tabSize) + 1) * tabSize : column + 1;
+			}
+		}
 
-//
-//	TextEditor::Document::getSectionText
-//
+		line.maxColumn = column;
+		line.colorize = true;
+		line.updateMinimap = true;
+		line.version++;
+	}
+
+	// determine maximum line number in document
+	maxColumn = 0;
+
+	for (auto line = begin(); line < end(); line++) {
+		maxColumn = std::max(maxColumn, line->maxColumn);
+	}
+
+	updated = true;
+}
+
+
+//
+//	TextEditor::Document::replaceSections
+//
+
+void TextEditor::Document::replaceSections(std::vector<Replacement>& replacements, const std::string_view& text) {
+	if (replacements.empty()) {
+		return;
+	}
+
+	// decode the new text once
+	std::vector<std::vector<Glyph>> insert(1);
+	auto endOfText = text.end();
+
+	for (auto i = text.begin(); i < endOfText;) {
+		ImWchar character;
+		i = CodePoint::read(i, endOfText, &character);
+
+		if (character == '\n') {
+			insert.emplace_back();
+
+		} else if (character != '\r') {
+			insert.back().emplace_back(character, Color::text);
+		}
+	}
+
+	// build the new list of lines, moving untouched lines over as is
+	std::vector<Line> result;
+	result.reserve(size() + (insert.size() - 1) * replacements.size());
+
+	Line pending;
+	auto pendingColumn = 0;
+	auto hasPending = false;
+	size_t sourceLine = 0;
+	size_t sourceIndex = 0;
+
+	auto advance = [this](int column, std::vector<Glyph>::const_iterator start, std::vector<Glyph>::const_iterator end) {
+		for (auto glyph = start; glyph < end; glyph++) {
+			column = (glyph->codepoint == '\t') ? ((column / tabSize) + 1) * tabSize : column + 1;
+		}
+
+		return column;
+	};
+
+	auto append = [&](std::vector<Glyph>::const_iterator start, std::vector<Glyph>::const_iterator end) {
+		pendingColumn = advance(pendingColumn, start, end);
+		pending.insert(pending.end(), start, end);
+	};
+
+	auto open = [&](const Line* line) {
+		pending = Line();
+		pending.marker = line ? line->marker : 0;
+		pending.state = line ? line->state : State::inText;
+		pending.version = line ? line->version : 0;
+		pendingColumn = 0;
+		hasPending = true;
+	};
+
+	auto emit = [&]() {
+		pending.maxColumn = pendingColumn;
+		pending.colorize = true;
+		pending.updateMinimap = true;
+		pending.version++;
+		result.emplace_back(std::move(pending));
+		hasPending = false;
+	};
+
+	for (auto& replacement : replacements) {
+		auto startLine = static_cast<size_t>(replacement.start.line);
+		auto endLine = static_cast<size_t>(replacement.end.line);
+		auto& line = at(startLine);
+		auto startIndex = getIndex(replacement.start);
+		auto endIndex = getIndex(replacement.end);
+
+		// copy the text between the previous replacement and this one
+		if (startLine > sourceLine) {
+			if (hasPending) {
+				auto& previous = at(sourceLine);
+				append(previous.begin() + sourceIndex, previous.end());
+				emit();
+
+			} else {
+				result.emplace_back(std::move(at(sourceLine)));
+			}
+
+			for (auto i = sourceLine + 1; i < startLine; i++) {
+				result.emplace_back(std::move(at(i)));
+			}
+
+			sourceIndex = 0;
+		}
+
+		if (!hasPending) {
+			open(&line);
+		}
+
+		append(line.begin() + sourceIndex, line.begin() + startIndex);
+
+		// determine where the section is once the previous replacements are done
+		auto newLine = static_cast<int>(result.size());
+		auto start = Coordinate(newLine, pendingColumn);
+
+		if (replacement.end.line == replacement.start.line) {
+			replacement.end = Coordinate(newLine, advance(pendingColumn, line.begin() + startIndex, line.begin() + endIndex));
+
+		} else {
+			replacement.end = Coordinate(newLine + replacement.end.line - replacement.start.line, replacement.end.column);
+		}
+
+		replacement.start = start;
+
+		// add the new text
+		append(insert[0].begin(), insert[0].end());
+
+		for (size_t i = 1; i < insert.size(); i++) {
+			emit();
+			open(nullptr);
+			append(insert[i].begin(), insert[i].end());
+		}
+
+		replacement.insertEnd = Coordinate(static_cast<int>(result.size()), pendingColumn);
+
+		// continue after the section
+		sourceLine = endLine;
+		sourceIndex = endIndex;
+	}
+
+	// copy the rest
+	auto& last = at(sourceLine);
+	append(last.begin() + sourceIndex, last.end());
+	emit();
+
+	for (auto i = sourceLine + 1; i < size(); i++) {
+		result.emplace_back(std::move(at(i)));
+	}
+
+	swap(result);
+
+	// determine maximum line number in document
+	maxColumn = 0;
+
+	for (auto line = begin(); line < end(); line++) {
+		maxColumn = std::max(maxColumn, line->maxColumn);
+	}
+
+	updated = true;
+}
+
+
+//
+//	TextEditor::Document::getText
+//
+
+std::string TextEditor::Document::getText() const {
+	// large files still have their source
+	if (lazy) {
+		return source;
+	}
+
+	// process all glyphs and generate UTF-8 output
+	std::string text;
+	char utf8[4];
+
+	for (auto line = begin(); line < end(); line++) {
+		for (auto glyph = line->begin(); glyph < line->end(); glyph++) {
+			text.append(std::string_view(utf8, CodePoint::write(utf8, glyph->codepoint)));
+		}
+
+		if (line < end() - 1) {
+			text += "\n";
+		}
+	}
+
+	return text;
+}
+
+
+//
+//	TextEditor::Document::getSectionText
+//
 
 std::string TextEditor::Document::getSectionText(Coordinate start, Coordinate end) const {
 	std::string section;
 
+	// large files: lines that haven't been decoded are taken from the source as a whole
+	if (lazy) {
+		char utf8[4];
+
+		for (auto lineNo = start.line; lineNo <= end.line; lineNo++) {
+			auto& line = at(lineNo);
+
+			if (line.decoded) {
+				auto index = (lineNo == start.line) ? getIndex(start) : 0;
+				auto endIndex = (lineNo == end.line) ? getIndex(end) : line.size();
+
+				for (; index < endIndex; index++) {
+					section.append(std::string_view(utf8, CodePoint::write(utf8, line[index].codepoint)));
+				}
+
+			} else if (lineNo < end.line || end.column > 0) {
+				std::string_view text(source.data() + lineOffsets[lineNo], lineOffsets[lineNo + 1] - lineOffsets[lineNo] - 1);
+
+				if (!text.empty() && text.back() == '\r') {
+					text.remove_suffix(1);
+				}
+
+				section.append(text);
+			}
+
+			if (lineNo < end.line) {
+				section += '\n';
+			}
+		}
+
+		return section;
+	}
+
 	auto lineNo = start.line;
 	auto index = getIndex(start);
 	auto endIndex = getIndex(end);
@@ -2743,6 +3825,8 @@ void TextEditor::Document::updateMaximumColumn(int first, int last) {
 		}
 
 		line->maxColumn = column;
+		line->version++;
+		line->updateMinimap = true;
 	}
 
 	// determine maximum line number in document
@@ -3136,7 +4220,10 @@ void TextEditor::Transactions::undo(Document& document, Cursors& cursors) {
 	auto& transaction = at(--undoIndex);
 
 	for (auto action = transaction->rbegin(); action < transaction->rend(); action++) {
-		if (action->type == Action::Type::insertText) {
+		if (action->type == Action::Type::replaceLines) {
+			document.replaceLines(action->lines, action->text);
+
+		} else if (action->type == Action::Type::insertText) {
 			document.deleteText(action->start, action->end);
 
 		} else {
@@ -3156,7 +4243,10 @@ void TextEditor::Transactions::redo(Document& document, Cursors& cursors) {
 	auto& transaction = at(undoIndex++);
 
 	for (auto action = transaction->rbegin(); action < transaction->rend(); action++) {
-		if (action->type == Action::Type::insertText) {
+		if (action->type == Action::Type::replaceLines) {
+			document.replaceLines(action->lines, action->replacement);
+
+		} else if (action->type == Action::Type::insertText) {
 			document.insertText(action->start, action->text);
 
 		} else {
@@ -3253,49 +4343,61 @@ TextEditor::State TextEditor::Colorizer::update(Line& line, const Language* lang
 
 			if (glyph == start) {
 				// nothing worked so far so it's time to do some tokenizing
-				Color color;
+				Color color = Color::text;
 				Iterator lineEnd(line.data() + line.size());
 				Iterator tokenStart(&*glyph);
-				Iterator tokenEnd;
-
-				// do we have an identifier
-				if (language->getIdentifier && (tokenEnd = language->getIdentifier(tokenStart, lineEnd)) != tokenStart) {
-					// determine identifier text and color color
-					auto size = tokenEnd - tokenStart;
-					std::string identifier;
-					color = Color::identifier;
-
-					for (auto i = tokenStart; i < tokenEnd; i++) {
-						identifier += *i;
-					}
+				Iterator tokenEnd = tokenStart;
 
-					if (language->keywords.find(identifier) != language->keywords.end()) {
-						color = Color::keyword;
+				// use the compiled lexer (if we have one)
+				if (!language->lexer.empty()) {
+					tokenEnd = language->lexer.match(tokenStart, lineEnd, color);
 
-					} else if (language->declarations.find(identifier) != language->declarations.end()) {
-						color = Color::declaration;
-
-					} else if (language->identifiers.find(identifier) != language->identifiers.end()) {
-						color = Color::knownIdentifier;
-					}
-
-					// colorize identifier and move on
-					setColor(glyph, glyph + size, color);
-					glyph += size;
+				// otherwise, do we have an identifier
+				} else if (language->getIdentifier && (tokenEnd = language->getIdentifier(tokenStart, lineEnd)) != tokenStart) {
+					color = Color::identifier;
 
 				// do we have a number
 				} else if (language->getNumber && (tokenEnd = language->getNumber(tokenStart, lineEnd)) != tokenStart) {
-					auto size = tokenEnd - tokenStart;
-					setColor(glyph, glyph + size, Color::number);
-					glyph += size;
+					color = Color::number;
 
 				// is this punctuation
 				} else if (language->isPunctuation && language->isPunctuation(glyph->codepoint)) {
-					(glyph++)->color = Color::punctuation;
+					tokenEnd++;
+					color = Color::punctuation;
+				}
 
-				} else {
+				if (tokenEnd == tokenStart) {
 					// I guess we don't know what this character is
 					(glyph++)->color = Color::text;
+
+				} else {
+					auto size = tokenEnd - tokenStart;
+
+					if (color == Color::identifier) {
+						// determine identifier text and color (reusing the buffer so this doesn't allocate)
+						identifier.clear();
+
+						for (auto i = tokenStart; i < tokenEnd; i++) {
+							identifier += *i;
+						}
+
+						if (language->keywords.find(identifier) != language->keywords.end()) {
+							color = Color::keyword;
+
+						} else if (language->declarations.find(identifier) != language->declarations.end()) {
+							color = Color::declaration;
+
+						} else if (language->identifiers.find(identifier) != language->identifiers.end()) {
+							color = Color::knownIdentifier;
+
+						} else if (identifiers && !identifiers->empty()) {
+							identifiers->find(tokenStart, tokenEnd, color);
+						}
+					}
+
+					// colorize token and move on
+					setColor(glyph, glyph + size, color);
+					glyph += size;
 				}
 			}
 
@@ -3390,6 +4492,7 @@ TextEditor::State TextEditor::Colorizer::update(Line& line, const Language* lang
 	}
 
 	line.colorize = false;
+	line.updateMinimap = true;
 	return state;
 }
 
@@ -3417,6 +4520,7 @@ void TextEditor::Colorizer::updateEntireDocument(Document& document, const Langu
 
 			line->state = State::inText;
 			line->colorize = false;
+			line->updateMinimap = true;
 		}
 	}
 }
@@ -3427,7 +4531,16 @@ void TextEditor::Colorizer::updateEntireDocument(Document& document, const Langu
 //
 
 void TextEditor::Colorizer::updateChangedLines(Document& document, const Language* language) {
-	for (auto line = document.begin(); line < document.end(); line++) {
+	updateChangedLines(document, language, 0, document.lineCount() - 1);
+}
+
+
+//
+//	TextEditor::Colorizer::updateChangedLines
+//
+
+void TextEditor::Colorizer::updateChangedLines(Document& document, const Language* language, int first, int last) {
+	for (auto line = document.begin() + first; line <= document.begin() + last; line++) {
 		if (line->colorize) {
 			auto state = update(*line, language);
 			auto next = line + 1;
@@ -3467,108 +4580,429 @@ bool TextEditor::Colorizer::matches(Line::iterator start, Line::iterator end, co
 
 
 //
-//	TextEditor::Bracketeer::reset
+//	TextEditor::Layout::reset
 //
 
-void TextEditor::Bracketeer::reset() {
-	clear();
-	active = -1;
-	activeLocation = Coordinate::invalid();
+void TextEditor::Layout::reset(int lines) {
+	lineCount = lines;
+	rowCount = lines;
+	hidden = 0;
+	extraRows = 0;
+	ends.assign(lines, -1);
+	folded.assign(lines, false);
+	covers.assign(lines, 0);
+	rows.assign(lines, 1);
+	foldedLines.clear();
+
+	// every line is a single visible row, so each node covers its full range
+	tree.resize(lines + 1);
+
+	for (int i = 1; i <= lines; i++) {
+		tree[i] = i & -i;
+	}
 }
 
 
 //
-//	TextEditor::Bracketeer::update
+//	TextEditor::Layout::update
 //
 
-void TextEditor::Bracketeer::update(Document& document) {
-	Color bracketColors[] = {
-		Color::matchingBracketLevel1,
-		Color::matchingBracketLevel2,
-		Color::matchingBracketLevel3
-	};
-
-	reset();
-	std::vector<size_t> levels;
-	int level = 0;
+void TextEditor::Layout::update(const Bracketeer& bracketeer, int lines) {
+	reset(lines);
 
-	// process all the glyphs
-	for (int line = 0; line < document.lineCount(); line++) {
-		for (size_t index = 0; index < document[line].size(); index++) {
-			auto& glyph = document[line][index];
+	// a fold needs at least one line between the opening and closing lines
+	// (if a line opens multiple multiline brackets, the biggest one wins)
+	for (auto& bracket : bracketeer) {
+		if (bracket.end.isValid() && bracket.end.line - bracket.start.line > 1 && bracket.start.line < lines && bracket.end.line < lines) {
+			ends[bracket.start.line] = std::max(ends[bracket.start.line], bracket.end.line);
+		}
+	}
+}
 
-			// handle a "bracket opener" that is not in a comment, string or preprocessor statement
-			if (isBracketCandidate(glyph) && isBracketOpener(glyph.codepoint)) {
-				// start a new level
-				levels.emplace_back(size());
-				emplace_back(glyph.codepoint, Coordinate(line, document.getColumn(line, index)), 0, Coordinate::invalid(), level);
-				glyph.color = bracketColors[level % 3];
-				level++;
 
-			// handle a "bracket closer" that is not in a comment, string or preprocessor statement
-			} else if (isBracketCandidate(glyph) && isBracketCloser(glyph.codepoint)) {
-				if (levels.size()) {
-					auto& lastBracket = at(levels.back());
-					levels.pop_back();
-					level--;
+//
+//	TextEditor::Layout::fold
+//
 
-					if (lastBracket.startChar == toBracketOpener(glyph.codepoint)) {
-						// handle matching bracket
-						glyph.color = bracketColors[level % 3];
-						lastBracket.endChar = glyph.codepoint;
-						lastBracket.end = Coordinate(line, document.getColumn(line, index));
+void TextEditor::Layout::fold(int line) {
+	if (isFoldable(line) && !folded[line]) {
+		folded[line] = true;
+		foldedLines.push_back(line);
+		cover(line, 1);
+	}
+}
 
-					} else {
-						// no matching bracket, mark brackets as errors
-						glyph.color = Color::matchingBracketError;
-						document[lastBracket.start.line][document.getIndex(lastBracket.start)].color = Color::matchingBracketError;
-						pop_back();
-					}
 
-				// this is a closer without an opener
-				} else {
-					glyph.color = Color::matchingBracketError;
-				}
-			}
-		}
-	}
+//
+//	TextEditor::Layout::unfold
+//
 
-	// handle levels left open and mark them as errors
-	if (levels.size()) {
-		for (auto i = levels.rbegin(); i < levels.rend(); i++) {
-			auto& start = at(*i).start;
-			document[start.line][document.getIndex(start)].color = Color::matchingBracketError;
-			erase(begin() + *i);
-		}
+void TextEditor::Layout::unfold(int line) {
+	if (isFolded(line)) {
+		folded[line] = false;
+		foldedLines.erase(std::find(foldedLines.begin(), foldedLines.end(), line));
+		cover(line, -1);
 	}
 }
 
 
 //
-//	TextEditor::Bracketeer::getActiveBracket
+//	TextEditor::Layout::foldAll
 //
 
-TextEditor::Bracketeer::iterator TextEditor::Bracketeer::getActiveBracket(Coordinate location) {
-	if (location != activeLocation) {
-		active = -1;
-		bool done = false;
+void TextEditor::Layout::foldAll() {
+	for (int line = 0; line < lineCount; line++) {
+		fold(line);
+	}
+}
 
-		for (auto i = begin(); !done && i < end(); i++) {
-			// skip pairs that start after specified location
-			if (i->isAfter(location)) {
-				done = true;
-			}
 
-			// brackets are active when they are around specified location
-			else if (i->isAround(location)) {
-				active = static_cast<int>(i - begin());
-			}
-		}
+//
+//	TextEditor::Layout::unfoldAll
+//
 
-		activeLocation = location;
+void TextEditor::Layout::unfoldAll() {
+	while (foldedLines.size()) {
+		unfold(foldedLines.back());
 	}
-
-	return active == -1 ? end() : begin() + active;
+}
+
+
+//
+//	TextEditor::Layout::reveal
+//
+
+void TextEditor::Layout::reveal(int line) {
+	if (isHidden(line)) {
+		for (size_t i = 0; i < foldedLines.size();) {
+			auto start = foldedLines[i];
+
+			if (start < line && ends[start] > line) {
+				unfold(start);
+
+			} else {
+				i++;
+			}
+		}
+	}
+}
+
+
+//
+//	TextEditor::Layout::setRows
+//
+
+void TextEditor::Layout::setRows(int line, int count) {
+	count = std::max(count, 1);
+
+	if (line >= 0 && line < lineCount && rows[line] != count) {
+		auto delta = count - rows[line];
+		rows[line] = count;
+		extraRows += delta;
+
+		if (covers[line] == 0) {
+			add(line, delta);
+		}
+	}
+}
+
+
+//
+//	TextEditor::Layout::getLine
+//
+
+int TextEditor::Layout::getLine(int row) const {
+	if (isUniform()) {
+		return row;
+	}
+
+	// find the line that contains the row by walking down the tree
+	int line = 0;
+	int remaining = row;
+	int step = 1;
+
+	while (step * 2 <= lineCount) {
+		step *= 2;
+	}
+
+	for (; step; step /= 2) {
+		if (line + step <= lineCount && tree[line + step] <= remaining) {
+			line += step;
+			remaining -= tree[line];
+		}
+	}
+
+	return line;
+}
+
+
+//
+//	TextEditor::Layout::cover
+//
+
+void TextEditor::Layout::cover(int line, int delta) {
+	for (int i = line + 1; i < ends[line]; i++) {
+		auto before = covers[i];
+		covers[i] += delta;
+
+		if (before == 0 && covers[i] > 0) {
+			add(i, -rows[i]);
+			hidden++;
+
+		} else if (before > 0 && covers[i] == 0) {
+			add(i, rows[i]);
+			hidden--;
+		}
+	}
+}
+
+
+//
+//	TextEditor::Layout::add
+//
+
+void TextEditor::Layout::add(int line, int delta) {
+	rowCount += delta;
+
+	for (int i = line + 1; i <= lineCount; i += i & -i) {
+		tree[i] += delta;
+	}
+}
+
+
+//
+//	TextEditor::Layout::prefix
+//
+
+int TextEditor::Layout::prefix(int line) const {
+	int result = 0;
+
+	for (int i = std::min(line, lineCount); i > 0; i -= i & -i) {
+		result += tree[i];
+	}
+
+	return result;
+}
+
+
+//
+//	TextEditor::Identifiers::hash
+//
+
+template <typename T>
+uint32_t TextEditor::Identifiers::hash(T start, T end) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	for (auto i = start; i != end; i++) {
+		hash = (hash ^ static_cast<uint32_t>(*i)) * 16777619u;
+	}
+
+	return hash;
+}
+
+
+//
+//	TextEditor::Identifiers::insert
+//
+
+void TextEditor::Identifiers::insert(const std::string_view& identifier, Color color) {
+	if (identifier.empty() || identifier.size() > std::numeric_limits<uint16_t>::max()) {
+		return;
+	}
+
+	// keep the table at most half full
+	if ((count + 1) * 2 > slots.size()) {
+		std::vector<Slot> old(std::max(slots.size() * 2, static_cast<size_t>(64)));
+		old.swap(slots);
+
+		for (auto& slot : old) {
+			if (slot.length) {
+				auto i = slot.hash & (slots.size() - 1);
+
+				while (slots[i].length) {
+					i = (i + 1) & (slots.size() - 1);
+				}
+
+				slots[i] = slot;
+			}
+		}
+	}
+
+	auto h = hash(identifier.begin(), identifier.end());
+	auto i = h & (slots.size() - 1);
+
+	while (slots[i].length) {
+		auto& slot = slots[i];
+
+		if (slot.hash == h && std::string_view(text.data() + slot.offset, slot.length) == identifier) {
+			slot.color = color;
+			return;
+		}
+
+		i = (i + 1) & (slots.size() - 1);
+	}
+
+	slots[i] = Slot{h, static_cast<uint32_t>(text.size()), static_cast<uint16_t>(identifier.size()), color};
+	text.append(identifier);
+	count++;
+}
+
+
+//
+//	TextEditor::Identifiers::clear
+//
+
+void TextEditor::Identifiers::clear() {
+	text.clear();
+	slots.clear();
+	count = 0;
+}
+
+
+//
+//	TextEditor::Identifiers::find
+//
+
+bool TextEditor::Identifiers::find(Iterator start, Iterator end, Color& color) const {
+	if (!count) {
+		return false;
+	}
+
+	auto h = hash(start, end);
+	auto length = end - start;
+	auto i = h & (slots.size() - 1);
+
+	while (slots[i].length) {
+		auto& slot = slots[i];
+
+		if (slot.hash == h && slot.length == length) {
+			auto match = true;
+			auto c = text.data() + slot.offset;
+
+			for (auto j = start; j != end; j++, c++) {
+				if (*j != static_cast<ImWchar>(*c)) {
+					match = false;
+					break;
+				}
+			}
+
+			if (match) {
+				color = slot.color;
+				return true;
+			}
+		}
+
+		i = (i + 1) & (slots.size() - 1);
+	}
+
+	return false;
+}
+
+
+//
+//	TextEditor::Bracketeer::reset
+//
+
+void TextEditor::Bracketeer::reset() {
+	clear();
+	active = -1;
+	activeLocation = Coordinate::invalid();
+}
+
+
+//
+//	TextEditor::Bracketeer::update
+//
+
+void TextEditor::Bracketeer::update(Document& document) {
+	Color bracketColors[] = {
+		Color::matchingBracketLevel1,
+		Color::matchingBracketLevel2,
+		Color::matchingBracketLevel3
+	};
+
+	reset();
+	std::vector<size_t> levels;
+	int level = 0;
+
+	// process all the glyphs
+	for (int line = 0; line < document.lineCount(); line++) {
+		for (size_t index = 0; index < document[line].size(); index++) {
+			auto& glyph = document[line][index];
+
+			// handle a "bracket opener" that is not in a comment, string or preprocessor statement
+			if (isBracketCandidate(glyph) && isBracketOpener(glyph.codepoint)) {
+				// start a new level
+				levels.emplace_back(size());
+				emplace_back(glyph.codepoint, Coordinate(line, document.getColumn(line, index)), 0, Coordinate::invalid(), level);
+				glyph.color = bracketColors[level % 3];
+				level++;
+
+			// handle a "bracket closer" that is not in a comment, string or preprocessor statement
+			} else if (isBracketCandidate(glyph) && isBracketCloser(glyph.codepoint)) {
+				if (levels.size()) {
+					auto& lastBracket = at(levels.back());
+					levels.pop_back();
+					level--;
+
+					if (lastBracket.startChar == toBracketOpener(glyph.codepoint)) {
+						// handle matching bracket
+						glyph.color = bracketColors[level % 3];
+						lastBracket.endChar = glyph.codepoint;
+						lastBracket.end = Coordinate(line, document.getColumn(line, index));
+
+					} else {
+						// no matching bracket, mark brackets as errors
+						glyph.color = Color::matchingBracketError;
+						document[lastBracket.start.line][document.getIndex(lastBracket.start)].color = Color::matchingBracketError;
+						pop_back();
+					}
+
+				// this is a closer without an opener
+				} else {
+					glyph.color = Color::matchingBracketError;
+				}
+			}
+		}
+	}
+
+	// handle levels left open and mark them as errors
+	if (levels.size()) {
+		for (auto i = levels.rbegin(); i < levels.rend(); i++) {
+			auto& start = at(*i).start;
+			document[start.line][document.getIndex(start)].color = Color::matchingBracketError;
+			erase(begin() + *i);
+		}
+	}
+}
+
+
+//
+//	TextEditor::Bracketeer::getActiveBracket
+//
+
+TextEditor::Bracketeer::iterator TextEditor::Bracketeer::getActiveBracket(Coordinate location) {
+	if (location != activeLocation) {
+		active = -1;
+		bool done = false;
+
+		for (auto i = begin(); !done && i < end(); i++) {
+			// skip pairs that start after specified location
+			if (i->isAfter(location)) {
+				done = true;
+			}
+
+			// brackets are active when they are around specified location
+			else if (i->isAround(location)) {
+				active = static_cast<int>(i - begin());
+			}
+		}
+
+		activeLocation = location;
+	}
+
+	return active == -1 ? end() : begin() + active;
 }
 
 
@@ -4863,1611 +6297,469 @@ ImWchar TextEditor::CodePoint::toLower(ImWchar codepoint) {
 
 
 //
-//	getCStyleIdentifier
+//	TextEditor::Lexer::Compiler
 //
 
-static TextEditor::Iterator getCStyleIdentifier(TextEditor::Iterator start, TextEditor::Iterator end) {
-	if (start < end && TextEditor::CodePoint::isXidStart(*start)) {
-		start++;
+class TextEditor::Lexer::Compiler {
+public:
+	using Set = std::bitset<atoms>;
+
+	// Thompson NFA: a state either moves to next on a codepoint in set or has up to two epsilon edges
+	struct State {
+		Set set;
+		int next = -1;
+		int epsilon[2] = {-1, -1};
+		int rule = -1;
+	};
+
+	// part of the NFA with a single start and a single (edgeless) end state
+	struct Fragment {
+		int start;
+		int end;
+	};
+
+	std::vector<State> states;
+
+	// build the NFA for a pattern
+	Fragment parse(const std::string_view& text) {
+		pattern = text;
+		position = 0;
+		auto fragment = parseAlternation();
+		IM_ASSERT(position == pattern.size() && "TextEditor::Lexer: unbalanced ')' in pattern");
+		return fragment;
+	}
+
+	int add() {
+		states.emplace_back();
+		return static_cast<int>(states.size() - 1);
+	}
 
-		while (start < end && TextEditor::CodePoint::isXidContinue(*start)) {
-			start++;
+	// add an NFA state and the states reachable from it through epsilon edges
+	void close(int state, std::vector<int>& result, std::vector<bool>& visited) const {
+		if (state < 0 || visited[state]) {
+			return;
 		}
+
+		visited[state] = true;
+		result.push_back(state);
+		close(states[state].epsilon[0], result, visited);
+		close(states[state].epsilon[1], result, visited);
 	}
 
-	return start;
-}
+private:
+	std::string_view pattern;
+	size_t position;
 
+	inline bool more() const { return position < pattern.size(); }
+	inline char peek() const { return pattern[position]; }
 
-//
-//	getCStyleNumber
-//
+	Fragment epsilon(Fragment a, int b) { states[a.end].epsilon[0] = b; return a; }
 
-static TextEditor::Iterator getCStyleNumber(TextEditor::Iterator start, TextEditor::Iterator end) {
-	TextEditor::Iterator i = start;
-	TextEditor::Iterator marker;
+	Fragment parseAlternation() {
+		auto fragment = parseSequence();
 
-	
-{
-	ImWchar yych;
-	unsigned int yyaccept = 0;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy3;
-		case '0': goto yy4;
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy6;
-		default:
-			if (i >= end) goto yy82;
-			goto yy1;
-	}
-yy1:
-	++i;
-yy2:
-	{ return start; }
-yy3:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy8;
-		default: goto yy2;
-	}
-yy4:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy5;
-		case 'B':
-		case 'b': goto yy16;
-		case 'X':
-		case 'x': goto yy20;
-		default: goto yy13;
-	}
-yy5:
-	{ return i; }
-yy6:
-	yyaccept = 1;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy10;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy6;
-		case 'E':
-		case 'e': goto yy17;
-		case 'L': goto yy22;
-		case 'U':
-		case 'u': goto yy23;
-		case 'l': goto yy24;
-		default: goto yy7;
-	}
-yy7:
-	{ return i; }
-yy8:
-	yyaccept = 2;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy8;
-		case 'E':
-		case 'e': goto yy25;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy26;
-		default: goto yy9;
-	}
-yy9:
-	{ return i; }
-yy10:
-	yyaccept = 3;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy8;
-		case 'E':
-		case 'e': goto yy27;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy28;
-		default: goto yy11;
-	}
-yy11:
-	{ return i; }
-yy12:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-yy13:
-	switch (yych) {
-		case '.': goto yy10;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7': goto yy12;
-		case '8':
-		case '9': goto yy14;
-		case 'E':
-		case 'e': goto yy17;
-		case 'L': goto yy18;
-		case 'U':
-		case 'u': goto yy19;
-		case 'l': goto yy21;
-		default: goto yy5;
-	}
-yy14:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy10;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy14;
-		case 'E':
-		case 'e': goto yy17;
-		default: goto yy15;
-	}
-yy15:
-	i = marker;
-	switch (yyaccept) {
-		case 0: goto yy5;
-		case 1: goto yy7;
-		case 2: goto yy9;
-		case 3: goto yy11;
-		default: goto yy40;
-	}
-yy16:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1': goto yy29;
-		default: goto yy15;
-	}
-yy17:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy31;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy32;
-		default: goto yy15;
-	}
-yy18:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy34;
-		case 'U':
-		case 'u': goto yy35;
-		default: goto yy5;
-	}
-yy19:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy36;
-		case 'l': goto yy37;
-		default: goto yy5;
-	}
-yy20:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy38;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy39;
-		default: goto yy15;
-	}
-yy21:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy35;
-		case 'l': goto yy34;
-		default: goto yy5;
-	}
-yy22:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy41;
-		case 'U':
-		case 'u': goto yy42;
-		default: goto yy7;
-	}
-yy23:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy43;
-		case 'l': goto yy44;
-		default: goto yy7;
-	}
-yy24:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy42;
-		case 'l': goto yy41;
-		default: goto yy7;
-	}
-yy25:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy45;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy46;
-		default: goto yy15;
-	}
-yy26:
-	++i;
-	goto yy9;
-yy27:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy47;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy48;
-		default: goto yy15;
-	}
-yy28:
-	++i;
-	goto yy11;
-yy29:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1': goto yy29;
-		case 'L': goto yy49;
-		case 'U':
-		case 'u': goto yy50;
-		case 'l': goto yy51;
-		default: goto yy30;
-	}
-yy30:
-	{ return i; }
-yy31:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy32;
-		default: goto yy15;
-	}
-yy32:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy32;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy52;
-		default: goto yy33;
-	}
-yy33:
-	{ return i; }
-yy34:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy35;
-		default: goto yy5;
-	}
-yy35:
-	++i;
-	goto yy5;
-yy36:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy35;
-		default: goto yy5;
-	}
-yy37:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy35;
-		default: goto yy5;
-	}
-yy38:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00:
-		case 'P':
-		case 'p': goto yy15;
-		default: goto yy54;
-	}
-yy39:
-	yyaccept = 4;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy55;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy39;
-		case 'L': goto yy56;
-		case 'P':
-		case 'p': goto yy57;
-		case 'U':
-		case 'u': goto yy58;
-		case 'l': goto yy59;
-		default: goto yy40;
-	}
-yy40:
-	{ return i; }
-yy41:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy42;
-		default: goto yy7;
-	}
-yy42:
-	++i;
-	goto yy7;
-yy43:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy42;
-		default: goto yy7;
-	}
-yy44:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy42;
-		default: goto yy7;
-	}
-yy45:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy46;
-		default: goto yy15;
-	}
-yy46:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy46;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy26;
-		default: goto yy9;
-	}
-yy47:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy48;
-		default: goto yy15;
-	}
-yy48:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy48;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy28;
-		default: goto yy11;
-	}
-yy49:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy60;
-		case 'U':
-		case 'u': goto yy61;
-		default: goto yy30;
-	}
-yy50:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy62;
-		case 'l': goto yy63;
-		default: goto yy30;
-	}
-yy51:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy61;
-		case 'l': goto yy60;
-		default: goto yy30;
-	}
-yy52:
-	++i;
-	goto yy33;
-yy53:
-	++i;
-	yych = i < end ? *i : 0;
-yy54:
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy53;
-		case 'P':
-		case 'p': goto yy64;
-		default: goto yy15;
-	}
-yy55:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy15;
-		case 'P':
-		case 'p': goto yy65;
-		default: goto yy54;
-	}
-yy56:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy66;
-		case 'U':
-		case 'u': goto yy67;
-		default: goto yy40;
-	}
-yy57:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy68;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy69;
-		default: goto yy15;
-	}
-yy58:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy71;
-		case 'l': goto yy72;
-		default: goto yy40;
-	}
-yy59:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy67;
-		case 'l': goto yy66;
-		default: goto yy40;
-	}
-yy60:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy61;
-		default: goto yy30;
-	}
-yy61:
-	++i;
-	goto yy30;
-yy62:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy61;
-		default: goto yy30;
-	}
-yy63:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy61;
-		default: goto yy30;
-	}
-yy64:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy73;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy74;
-		default: goto yy15;
-	}
-yy65:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy76;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy77;
-		default: goto yy15;
-	}
-yy66:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy67;
-		default: goto yy40;
-	}
-yy67:
-	++i;
-	goto yy40;
-yy68:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy69;
-		default: goto yy15;
-	}
-yy69:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy69;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy79;
-		default: goto yy70;
-	}
-yy70:
-	{ return i; }
-yy71:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy67;
-		default: goto yy40;
-	}
-yy72:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy67;
-		default: goto yy40;
-	}
-yy73:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy74;
-		default: goto yy15;
-	}
-yy74:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy74;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy80;
-		default: goto yy75;
-	}
-yy75:
-	{ return i; }
-yy76:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy77;
-		default: goto yy15;
-	}
-yy77:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy77;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy81;
-		default: goto yy78;
-	}
-yy78:
-	{ return i; }
-yy79:
-	++i;
-	goto yy70;
-yy80:
-	++i;
-	goto yy75;
-yy81:
-	++i;
-	goto yy78;
-yy82:
-	{ return start; }
-}
-
-}
-
-
-//
-//	isCStylePunctuation
-//
-
-static bool isCStylePunctuation(ImWchar character) {
-	static bool punctuation[128] = {
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false,  true, false, false, false,  true,  true, false,  true,  true,  true,  true,  true,  true,  true,  true,
-		false, false, false, false, false, false, false, false, false, false,  true,  true,  true,  true,  true,  true,
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false, false, false, false, false, false, false, false, false, false, false,  true, false,  true,  true, false,
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false, false, false, false, false, false, false, false, false, false, false,  true,  true,  true,  true, false,
-	};
-
-	return character < 127 ? punctuation[character] : false;
-}
-
-
-//
-//	TextEditor::Language::C
-//
-
-const TextEditor::Language* TextEditor::Language::C() {
-	static bool initialized = false;
-	static TextEditor::Language language;
-
-	if (!initialized) {
-		language.name = "C";
-		language.preprocess = '#';
-		language.singleLineComment = "//";
-		language.commentStart = "/*";
-		language.commentEnd = "*/";
-		language.hasSingleQuotedStrings = true;
-		language.hasDoubleQuotedStrings = true;
-		language.stringEscape = '\\';
-
-		static const char* const keywords[] = {
-			"break", "case", "continue", "default", "do", "else", "for", "goto", "if", "return", "sizeof",
-			"switch", "while", "_Alignas", "_Alignof", "_Atomic", "_Bool", "_Complex", "_Generic",
-			"_Imaginary", "_Noreturn", "_Static_assert", "_Thread_local"
-		};
-
-		static const char* const declarations[] = {
-			"auto", "char", "const", "double", "enum", "extern", "float", "inline", "int", "long", "register",
-			"restrict", "short", "signed", "static", "struct", "typedef", "union", "unsigned", "void", "volatile"
-		};
-
-		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
-		for (auto& declaration : declarations) { language.declarations.insert(declaration); }
-
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getCStyleNumber;
-		initialized = true;
-	}
-
-	return &language;
-}
-
-
-//
-//	TextEditor::Language::Cpp
-//
-
-const TextEditor::Language* TextEditor::Language::Cpp() {
-	static bool initialized = false;
-	static TextEditor::Language language;
-
-	if (!initialized) {
-		language.name = "C++";
-		language.preprocess = '#';
-		language.singleLineComment = "//";
-		language.commentStart = "/*";
-		language.commentEnd = "*/";
-		language.hasSingleQuotedStrings = true;
-		language.hasDoubleQuotedStrings = true;
-		language.stringEscape = '\\';
-
-		static const char* const keywords[] = {
-			"alignas", "alignof", "and", "and_eq", "asm", "atomic_cancel", "atomic_commit", "atomic_noexcept",
-			"bitand", "bitor", "break", "case", "catch", "compl", "const_cast", "continue", "default", "delete",
-			"do", "dynamic_cast", "else", "explicit", "export", "extern", "false", "for", "goto", "if", "import",
-			"new", "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "reinterpret_cast", "requires",
-			"return", "sizeof", "static_assert", "static_cast", "switch", "synchronized", "this", "thread_local",
-			"throw", "true", "try", "while", "xor", "xor_eq"
-		};
-
-		static const char* const declarations[] = {
-			"auto", "bool", "char", "char16_t", "char32_t", "class", "concept", "const", "constexpr", "decltype",
-			"double", "explicit", "export", "extern", "enum", "extern", "float", "friend", "inline", "int", "long",
-			"module", "mutable", "namespace", "private", "protected", "public", "register", "restrict", "short",
-			"signed", "static", "struct", "template", "typedef", "typeid", "typename", "union", "using", "unsigned",
-			"virtual", "void", "volatile", "wchar_t"
-		};
-
-		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
-		for (auto& declaration : declarations) { language.declarations.insert(declaration); }
-
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getCStyleNumber;
-		initialized = true;
-	}
-
-	return &language;
-}
-
-
-//
-//	getCsStyleNumber
-//
-
-static TextEditor::Iterator getCsStyleNumber(TextEditor::Iterator start, TextEditor::Iterator end) {
-	TextEditor::Iterator i = start;
-	TextEditor::Iterator marker;
-
-	
-{
-	ImWchar yych;
-	unsigned int yyaccept = 0;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy3;
-		case '0': goto yy4;
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy6;
-		default:
-			if (i >= end) goto yy49;
-			goto yy1;
-	}
-yy1:
-	++i;
-yy2:
-	{ return start; }
-yy3:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy8;
-		default: goto yy2;
-	}
-yy4:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy5;
-		case 'B':
-		case 'b': goto yy12;
-		case 'X':
-		case 'x': goto yy15;
-		default: goto yy7;
-	}
-yy5:
-	{ return i; }
-yy6:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-yy7:
-	switch (yych) {
-		case '.': goto yy10;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy6;
-		case 'L': goto yy13;
-		case 'U':
-		case 'u': goto yy14;
-		case 'l': goto yy16;
-		default: goto yy5;
-	}
-yy8:
-	yyaccept = 1;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy8;
-		case 'E':
-		case 'e': goto yy17;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy18;
-		default: goto yy9;
-	}
-yy9:
-	{ return i; }
-yy10:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy19;
-		default: goto yy11;
-	}
-yy11:
-	i = marker;
-	switch (yyaccept) {
-		case 0: goto yy5;
-		case 1: goto yy9;
-		default: goto yy20;
-	}
-yy12:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1': goto yy21;
-		default: goto yy11;
-	}
-yy13:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy23;
-		case 'U':
-		case 'u': goto yy24;
-		default: goto yy5;
-	}
-yy14:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy25;
-		case 'l': goto yy26;
-		default: goto yy5;
-	}
-yy15:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy27;
-		default: goto yy11;
-	}
-yy16:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy24;
-		case 'l': goto yy23;
-		default: goto yy5;
-	}
-yy17:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy29;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy30;
-		default: goto yy11;
-	}
-yy18:
-	++i;
-	goto yy9;
-yy19:
-	yyaccept = 2;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy19;
-		case 'E':
-		case 'e': goto yy31;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy32;
-		default: goto yy20;
-	}
-yy20:
-	{ return i; }
-yy21:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '_': goto yy21;
-		case 'L': goto yy33;
-		case 'U':
-		case 'u': goto yy34;
-		case 'l': goto yy35;
-		default: goto yy22;
-	}
-yy22:
-	{ return i; }
-yy23:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy24;
-		default: goto yy5;
-	}
-yy24:
-	++i;
-	goto yy5;
-yy25:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy24;
-		default: goto yy5;
-	}
-yy26:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy24;
-		default: goto yy5;
-	}
-yy27:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case '_':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy27;
-		case 'L': goto yy36;
-		case 'U':
-		case 'u': goto yy37;
-		case 'l': goto yy38;
-		default: goto yy28;
-	}
-yy28:
-	{ return i; }
-yy29:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy30;
-		default: goto yy11;
-	}
-yy30:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy30;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy18;
-		default: goto yy9;
-	}
-yy31:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy39;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy40;
-		default: goto yy11;
-	}
-yy32:
-	++i;
-	goto yy20;
-yy33:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy41;
-		case 'U':
-		case 'u': goto yy42;
-		default: goto yy22;
-	}
-yy34:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy43;
-		case 'l': goto yy44;
-		default: goto yy22;
-	}
-yy35:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy42;
-		case 'l': goto yy41;
-		default: goto yy22;
-	}
-yy36:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy45;
-		case 'U':
-		case 'u': goto yy46;
-		default: goto yy28;
-	}
-yy37:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy47;
-		case 'l': goto yy48;
-		default: goto yy28;
+		while (more() && peek() == '|') {
+			position++;
+			auto other = parseSequence();
+			auto start = add();
+			auto end = add();
+			states[start].epsilon[0] = fragment.start;
+			states[start].epsilon[1] = other.start;
+			states[fragment.end].epsilon[0] = end;
+			states[other.end].epsilon[0] = end;
+			fragment = Fragment{start, end};
+		}
+
+		return fragment;
 	}
-yy38:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy46;
-		case 'l': goto yy45;
-		default: goto yy28;
+
+	Fragment parseSequence() {
+		auto start = add();
+		Fragment fragment{start, start};
+
+		while (more() && peek() != '|' && peek() != ')') {
+			auto next = parseRepeat();
+			states[fragment.end].epsilon[0] = next.start;
+			fragment.end = next.end;
+		}
+
+		return fragment;
 	}
-yy39:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy40;
-		default: goto yy11;
+
+	Fragment parseRepeat() {
+		auto fragment = parseAtom();
+
+		while (more() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+			auto op = pattern[position++];
+			auto end = add();
+
+			if (op == '+') {
+				states[fragment.end].epsilon[0] = fragment.start;
+				states[fragment.end].epsilon[1] = end;
+				fragment.end = end;
+
+			} else {
+				auto start = add();
+				states[start].epsilon[0] = fragment.start;
+				states[start].epsilon[1] = end;
+				states[fragment.end].epsilon[0] = (op == '*') ? fragment.start : end;
+				states[fragment.end].epsilon[1] = (op == '*') ? end : -1;
+				fragment = Fragment{start, end};
+			}
+		}
+
+		return fragment;
 	}
-yy40:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy40;
-		case 'F':
-		case 'L':
-		case 'f':
-		case 'l': goto yy32;
-		default: goto yy20;
+
+	Fragment parseAtom() {
+		IM_ASSERT(more() && "TextEditor::Lexer: unexpected end of pattern");
+		auto c = pattern[position++];
+
+		if (c == '(') {
+			auto fragment = parseAlternation();
+			IM_ASSERT(more() && peek() == ')' && "TextEditor::Lexer: missing ')' in pattern");
+			position++;
+			return fragment;
+		}
+
+		Set set;
+
+		if (c == '[') {
+			set = parseSet();
+
+		} else if (c == '.') {
+			set.set();
+
+		} else if (c == '\\') {
+			set = parseEscape();
+
+		} else {
+			IM_ASSERT(c != '*' && c != '+' && c != '?' && "TextEditor::Lexer: nothing to repeat in pattern");
+			set.set(static_cast<unsigned char>(c) & 0x7f);
+		}
+
+		auto start = add();
+		auto end = add();
+		states[start].set = set;
+		states[start].next = end;
+		return Fragment{start, end};
 	}
-yy41:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy42;
-		default: goto yy22;
+
+	Set parseEscape() {
+		IM_ASSERT(more() && "TextEditor::Lexer: unexpected end of pattern");
+		auto c = pattern[position++];
+		Set set;
+
+		auto range = [&](char first, char last) {
+			for (auto i = first; i <= last; i++) {
+				set.set(static_cast<size_t>(i));
+			}
+		};
+
+		switch (c) {
+			case 'd':
+				range('0', '9');
+				break;
+
+			case 'w':
+				range('0', '9');
+				range('a', 'z');
+				range('A', 'Z');
+				set.set('_');
+				break;
+
+			case 's':
+				set.set(' ');
+				set.set('\t');
+				set.set('\r');
+				set.set('\n');
+				set.set('\f');
+				set.set('\v');
+				break;
+
+			case 'c':
+				range('0', '9');
+				set.set(129);
+				// fall through
+
+			case 'i':
+				range('a', 'z');
+				range('A', 'Z');
+				set.set('_');
+				set.set(128);
+				break;
+
+			default:
+				set.set(static_cast<unsigned char>(c) & 0x7f);
+				break;
+		}
+
+		return set;
 	}
-yy42:
-	++i;
-	goto yy22;
-yy43:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy42;
-		default: goto yy22;
+
+	Set parseSet() {
+		Set set;
+		auto negate = more() && peek() == '^';
+
+		if (negate) {
+			position++;
+		}
+
+		// a leading ']' is a literal
+		auto first = true;
+
+		while (more() && (first || peek() != ']')) {
+			auto c = pattern[position++];
+			first = false;
+
+			if (c == '\\') {
+				set |= parseEscape();
+
+			} else if (position + 1 < pattern.size() && peek() == '-' && pattern[position + 1] != ']') {
+				auto last = pattern[position + 1];
+				position += 2;
+
+				for (auto i = static_cast<unsigned char>(c); i <= static_cast<unsigned char>(last); i++) {
+					set.set(i & 0x7f);
+				}
+
+			} else {
+				set.set(static_cast<unsigned char>(c) & 0x7f);
+			}
+		}
+
+		IM_ASSERT(more() && "TextEditor::Lexer: missing ']' in pattern");
+		position++;
+		return negate ? ~set : set;
 	}
-yy44:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy42;
-		default: goto yy22;
+};
+
+
+//
+//	TextEditor::Lexer::addRule
+//
+
+void TextEditor::Lexer::addRule(const std::string_view& pattern, Color color) {
+	rules.emplace_back(Rule{std::string(pattern), color});
+}
+
+
+//
+//	TextEditor::Lexer::compile
+//
+
+void TextEditor::Lexer::compile() {
+	// build one NFA for all rules, starting with a chain of epsilon states
+	Compiler compiler;
+	auto start = compiler.add();
+	auto chain = start;
+
+	for (size_t i = 0; i < rules.size(); i++) {
+		auto fragment = compiler.parse(rules[i].pattern);
+		compiler.states[fragment.end].rule = static_cast<int>(i);
+		compiler.states[chain].epsilon[0] = fragment.start;
+
+		if (i + 1 < rules.size()) {
+			auto next = compiler.add();
+			compiler.states[chain].epsilon[1] = next;
+			chain = next;
+		}
 	}
-yy45:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'U':
-		case 'u': goto yy46;
-		default: goto yy28;
+
+	// group atoms that every edge treats the same way into character classes
+	std::vector<Compiler::Set> sets;
+
+	for (auto& state : compiler.states) {
+		if (state.next >= 0 && std::find(sets.begin(), sets.end(), state.set) == sets.end()) {
+			sets.emplace_back(state.set);
+		}
 	}
-yy46:
-	++i;
-	goto yy28;
-yy47:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'L': goto yy46;
-		default: goto yy28;
+
+	std::vector<std::vector<bool>> signatures;
+	std::vector<size_t> representatives;
+
+	for (size_t atom = 0; atom < atoms; atom++) {
+		std::vector<bool> signature(sets.size());
+
+		for (size_t i = 0; i < sets.size(); i++) {
+			signature[i] = sets[i][atom];
+		}
+
+		auto found = std::find(signatures.begin(), signatures.end(), signature);
+
+		if (found == signatures.end()) {
+			classes[atom] = static_cast<uint8_t>(signatures.size());
+			signatures.emplace_back(std::move(signature));
+			representatives.emplace_back(atom);
+
+		} else {
+			classes[atom] = static_cast<uint8_t>(found - signatures.begin());
+		}
 	}
-yy48:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy46;
-		default: goto yy28;
+
+	classCount = signatures.size();
+
+	// subset construction
+	std::map<std::vector<int>, uint16_t> dfaStates;
+	std::vector<std::vector<int>> pending;
+
+	auto addState = [&](std::vector<int>&& nfaStates) -> uint16_t {
+		std::sort(nfaStates.begin(), nfaStates.end());
+		auto found = dfaStates.find(nfaStates);
+
+		if (found != dfaStates.end()) {
+			return found->second;
+		}
+
+		IM_ASSERT(dfaStates.size() < std::numeric_limits<uint16_t>::max() && "TextEditor::Lexer: too many states");
+		auto id = static_cast<uint16_t>(dfaStates.size());
+		int16_t rule = -1;
+
+		for (auto state : nfaStates) {
+			auto r = compiler.states[state].rule;
+
+			if (r >= 0 && (rule < 0 || r < rule)) {
+				rule = static_cast<int16_t>(r);
+			}
+		}
+
+		accepts.emplace_back(rule);
+		transitions.resize(transitions.size() + classCount, 0);
+		dfaStates.emplace(nfaStates, id);
+		pending.emplace_back(std::move(nfaStates));
+		return id;
+	};
+
+	transitions.clear();
+	accepts.clear();
+
+	std::vector<bool> visited(compiler.states.size());
+	std::vector<int> closure;
+	addState(std::move(closure));
+
+	closure.clear();
+	compiler.close(start, closure, visited);
+	addState(std::move(closure));
+
+	for (size_t id = 1; id < pending.size(); id++) {
+		for (size_t cls = 0; cls < classCount; cls++) {
+			auto atom = representatives[cls];
+			std::fill(visited.begin(), visited.end(), false);
+			closure.clear();
+
+			for (auto state : pending[id]) {
+				auto& nfa = compiler.states[state];
+
+				if (nfa.next >= 0 && nfa.set[atom]) {
+					compiler.close(nfa.next, closure, visited);
+				}
+			}
+
+			if (!closure.empty()) {
+				auto next = addState(std::move(closure));
+				transitions[id * classCount + cls] = next;
+			}
+
+			closure.clear();
+		}
 	}
-yy49:
-	{ return start; }
 }
 
+
+//
+//	TextEditor::Lexer::match
+//
+
+TextEditor::Iterator TextEditor::Lexer::match(Iterator start, Iterator end, Color& color) const {
+	auto state = 1;
+	auto last = start;
+
+	for (auto i = start; i < end;) {
+		auto codepoint = *i;
+		size_t atom;
+
+		if (codepoint < 0x80) {
+			atom = codepoint;
+
+		} else if (CodePoint::isXidStart(codepoint)) {
+			atom = 128;
+
+		} else if (CodePoint::isXidContinue(codepoint)) {
+			atom = 129;
+
+		} else {
+			atom = 130;
+		}
+
+		state = transitions[state * classCount + classes[atom]];
+
+		if (!state) {
+			break;
+		}
+
+		i++;
+
+		if (accepts[state] >= 0) {
+			last = i;
+			color = rules[accepts[state]].color;
+		}
+	}
+
+	return last;
 }
 
 
 //
-//	TextEditor::Language::Cs
+//	token rules for the predefined languages
 //
 
-const TextEditor::Language* TextEditor::Language::Cs() {
-	static bool initialized = false;
-	static TextEditor::Language language;
+static constexpr const char* cStyleIdentifier = "\\i\\c*";
+static constexpr const char* cStylePunctuation = "[!%&()*+,\\-./:;<=>?\\[\\]^{|}~]";
+static constexpr const char* luaStylePunctuation = "[!#%&()*+,\\-./:;<=>?\\[\\]^{|}~]";
 
-	if (!initialized) {
-		language.name = "C#";
-		language.preprocess = '#';
-		language.singleLineComment = "//";
-		language.commentStart = "/*";
-		language.commentEnd = "*/";
-		language.hasSingleQuotedStrings = true;
-		language.hasDoubleQuotedStrings = true;
-		language.stringEscape = '\\';
+static constexpr const char* cStyleNumber =
+	"(0[xX][0-9a-fA-F]+|0[bB][01]+|0[0-7]*|[1-9][0-9]*)([uU](l|L|ll|LL)?|(l|L|ll|LL)[uU]?)?|"
+	"([0-9]+\\.[0-9]*|\\.[0-9]+)([eE][+-]?[0-9]+)?[fFlL]?|"
+	"[0-9]+[eE][+-]?[0-9]+[fFlL]?|"
+	"0[xX]([0-9a-fA-F]+\\.?[0-9a-fA-F]*|\\.[0-9a-fA-F]+)[pP][+-]?[0-9]+[fFlL]?";
 
-		static const char* const keywords[] = {
-			"abstract", "as", "base", "bool", "break", "byte", "case", "catch", "char", "checked", "class", "const", "continue",
-			"decimal", "default", "delegate", "do", "double", "else", "enum", "event", "explicit", "extern", "false", "finally",
-			"fixed", "float", "for", "foreach", "goto", "if", "implicit", "in", "in (generic modifier)", "int", "interface",
-			"internal", "is", "lock", "long", "namespace", "new", "null", "object", "operator", "out", "override", "params",
-			"private", "protected", "public", "readonly", "ref", "return", "sbyte", "sealed", "short", "sizeof", "stackalloc",
-			"static", "string", "struct", "switch", "this", "throw", "true", "try", "typeof", "uint", "ulong", "unchecked",
-			"unsafe", "ushort", "using", "using static", "void", "volatile", "while"
-		};
+static constexpr const char* csStyleNumber =
+	"(0[xX][0-9a-fA-F][0-9a-fA-F_]*|0[bB][01][01_]*|[0-9][0-9_]*)([uU](l|L|ll|LL)?|(l|L|ll|LL)[uU]?)?|"
+	"([0-9][0-9_]*)?\\.[0-9][0-9_]*([eE][+-]?[0-9_]+)?[fFlL]?";
 
-		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
+static constexpr const char* luaStyleNumber =
+	"0[xX][0-9a-fA-F]+(\\.[0-9a-fA-F]*)?([pP][+-]?[0-9a-fA-F]*)?|"
+	"([0-9]+\\.?[0-9]*|\\.[0-9]*)([eE][+-]?[0-9]*)?";
 
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getCsStyleNumber;
-		initialized = true;
-	}
+static constexpr const char* pythonStyleNumber =
+	"[0-9][0-9_]*(\\.[0-9][0-9_]*)?([eE+-][0-9][0-9_]*)?[jJ]?|"
+	"0[xX][0-9a-fA-F_]+|0[oO][0-7_]+|0[bB][01_]+";
 
-	return &language;
+static constexpr const char* jsonNumber = "-?(0|[1-9][0-9]*)(\\.[0-9]+)?([eE][+-]?[0-9]+)?";
+
+
+//
+//	compileCStyleLexer
+//
+
+static void compileCStyleLexer(TextEditor::Lexer& lexer, const char* number, const char* punctuation) {
+	lexer.addRule(cStyleIdentifier, TextEditor::Color::identifier);
+	lexer.addRule(number, TextEditor::Color::number);
+	lexer.addRule(punctuation, TextEditor::Color::punctuation);
+	lexer.compile();
 }
 
 
 //
-//	TextEditor::Language::AngelScript
+//	TextEditor::Language::C
 //
 
-const TextEditor::Language* TextEditor::Language::AngelScript() {
+const TextEditor::Language* TextEditor::Language::C() {
 	static bool initialized = false;
 	static TextEditor::Language language;
 
 	if (!initialized) {
-		language.name = "AngelScript";
+		language.name = "C";
 		language.preprocess = '#';
 		language.singleLineComment = "//";
 		language.commentStart = "/*";
@@ -6477,19 +6769,20 @@ const TextEditor::Language* TextEditor::Language::AngelScript() {
 		language.stringEscape = '\\';
 
 		static const char* const keywords[] = {
-			"and", "abstract", "auto", "bool", "break", "case", "cast", "class", "const", "continue", "default",
-			"do", "double", "else", "enum", "false", "final", "float", "for", "from", "funcdef", "function", "get",
-			"if", "import", "in", "inout", "int", "interface", "int8", "int16", "int32", "int64", "is", "mixin",
-			"namespace", "not", "null", "or", "out", "override", "private", "protected", "return", "set", "shared",
-			"super", "switch", "this ", "true", "typedef", "uint", "uint8", "uint16", "uint32", "uint64", "void",
-			"while", "xor", "foreach", "nodiscard"
+			"break", "case", "continue", "default", "do", "else", "for", "goto", "if", "return", "sizeof",
+			"switch", "while", "_Alignas", "_Alignof", "_Atomic", "_Bool", "_Complex", "_Generic",
+			"_Imaginary", "_Noreturn", "_Static_assert", "_Thread_local"
+		};
+
+		static const char* const declarations[] = {
+			"auto", "char", "const", "double", "enum", "extern", "float", "inline", "int", "long", "register",
+			"restrict", "short", "signed", "static", "struct", "typedef", "union", "unsigned", "void", "volatile"
 		};
 
 		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
+		for (auto& declaration : declarations) { language.declarations.insert(declaration); }
 
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getCStyleNumber;
+		compileCStyleLexer(language.lexer, cStyleNumber, cStylePunctuation);
 		initialized = true;
 	}
 
@@ -6498,314 +6791,82 @@ const TextEditor::Language* TextEditor::Language::AngelScript() {
 
 
 //
-//	getLuaStyleNumber
+//	TextEditor::Language::Cpp
 //
 
-static TextEditor::Iterator getLuaStyleNumber(TextEditor::Iterator start, TextEditor::Iterator end) {
-	TextEditor::Iterator i = start;
-	TextEditor::Iterator marker;
+const TextEditor::Language* TextEditor::Language::Cpp() {
+	static bool initialized = false;
+	static TextEditor::Language language;
 
-	
-{
-	ImWchar yych;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy2;
-		case '0': goto yy5;
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy6;
-		case 'E':
-		case 'e': goto yy7;
-		default:
-			if (i >= end) goto yy17;
-			goto yy1;
-	}
-yy1:
-	++i;
-	{ return start; }
-yy2:
-	++i;
-	yych = i < end ? *i : 0;
-yy3:
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy2;
-		case 'E':
-		case 'e': goto yy7;
-		default: goto yy4;
-	}
-yy4:
-	{
-			return i;
-		}
-yy5:
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy4;
-		case '.': goto yy2;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy6;
-		case 'X':
-		case 'x': goto yy8;
-		default: goto yy3;
-	}
-yy6:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy2;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy6;
-		case 'E':
-		case 'e': goto yy7;
-		default: goto yy4;
-	}
-yy7:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy4;
-		case '+':
-		case '-': goto yy10;
-		default: goto yy11;
-	}
-yy8:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy12;
-		default: goto yy9;
-	}
-yy9:
-	i = marker;
-	goto yy4;
-yy10:
-	++i;
-	yych = i < end ? *i : 0;
-yy11:
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy10;
-		default: goto yy4;
-	}
-yy12:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy13;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy12;
-		case 'P':
-		case 'p': goto yy14;
-		default: goto yy4;
-	}
-yy13:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy13;
-		case 'P':
-		case 'p': goto yy14;
-		default: goto yy4;
-	}
-yy14:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy4;
-		case '+':
-		case '-': goto yy15;
-		default: goto yy16;
-	}
-yy15:
-	++i;
-	yych = i < end ? *i : 0;
-yy16:
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy15;
-		default: goto yy4;
-	}
-yy17:
-	{ return start; }
-}
+	if (!initialized) {
+		language.name = "C++";
+		language.preprocess = '#';
+		language.singleLineComment = "//";
+		language.commentStart = "/*";
+		language.commentEnd = "*/";
+		language.hasSingleQuotedStrings = true;
+		language.hasDoubleQuotedStrings = true;
+		language.stringEscape = '\\';
 
-}
+		static const char* const keywords[] = {
+			"alignas", "alignof", "and", "and_eq", "asm", "atomic_cancel", "atomic_commit", "atomic_noexcept",
+			"bitand", "bitor", "break", "case", "catch", "compl", "const_cast", "continue", "default", "delete",
+			"do", "dynamic_cast", "else", "explicit", "export", "extern", "false", "for", "goto", "if", "import",
+			"new", "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "reinterpret_cast", "requires",
+			"return", "sizeof", "static_assert", "static_cast", "switch", "synchronized", "this", "thread_local",
+			"throw", "true", "try", "while", "xor", "xor_eq"
+		};
 
+		static const char* const declarations[] = {
+			"auto", "bool", "char", "char16_t", "char32_t", "class", "concept", "const", "constexpr", "decltype",
+			"double", "explicit", "export", "extern", "enum", "extern", "float", "friend", "inline", "int", "long",
+			"module", "mutable", "namespace", "private", "protected", "public", "register", "restrict", "short",
+			"signed", "static", "struct", "template", "typedef", "typeid", "typename", "union", "using", "unsigned",
+			"virtual", "void", "volatile", "wchar_t"
+		};
 
-//
-//	isLuaStylePuctuation
-//	[]{}!%#^&*()-+=~|<>?:/;,.
-//
+		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
+		for (auto& declaration : declarations) { language.declarations.insert(declaration); }
 
-static bool isLuaStylePunctuation(ImWchar character) {
-	static bool punctuation[128] = {
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false,  true, false,  true, false,  true,  true, false,  true,  true,  true,  true,  true,  true,  true,  true,
-		false, false, false, false, false, false, false, false, false, false,  true,  true,  true,  true,  true,  true,
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false, false, false, false, false, false, false, false, false, false, false,  true, false,  true,  true, false,
-		false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
-		false, false, false, false, false, false, false, false, false, false, false,  true,  true,  true,  true, false,
-	};
+		compileCStyleLexer(language.lexer, cStyleNumber, cStylePunctuation);
+		initialized = true;
+	}
 
-	return character < 127 ? punctuation[character] : false;
+	return &language;
 }
 
 
 //
-//	TextEditor::Language::Lua
+//	TextEditor::Language::Cs
 //
 
-const TextEditor::Language* TextEditor::Language::Lua() {
+const TextEditor::Language* TextEditor::Language::Cs() {
 	static bool initialized = false;
 	static TextEditor::Language language;
 
 	if (!initialized) {
-		language.name = "Lua";
-		language.singleLineComment = "--";
-		language.commentStart = "--[[";
-		language.commentEnd = "]]";
+		language.name = "C#";
+		language.preprocess = '#';
+		language.singleLineComment = "//";
+		language.commentStart = "/*";
+		language.commentEnd = "*/";
 		language.hasSingleQuotedStrings = true;
 		language.hasDoubleQuotedStrings = true;
-		language.otherStringStart = "[[";
-		language.otherStringEnd = "]]";
 		language.stringEscape = '\\';
 
 		static const char* const keywords[] = {
-			"and", "break", "do", "else", "elseif", "end", "false", "for", "function", "goto", "if", "in", "local", "nil",
-			"not", "or", "repeat", "return", "then", "true", "until", "while"
+			"abstract", "as", "base", "bool", "break", "byte", "case", "catch", "char", "checked", "class", "const", "continue",
+			"decimal", "default", "delegate", "do", "double", "else", "enum", "event", "explicit", "extern", "false", "finally",
+			"fixed", "float", "for", "foreach", "goto", "if", "implicit", "in", "in (generic modifier)", "int", "interface",
+			"internal", "is", "lock", "long", "namespace", "new", "null", "object", "operator", "out", "override", "params",
+			"private", "protected", "public", "readonly", "ref", "return", "sbyte", "sealed", "short", "sizeof", "stackalloc",
+			"static", "string", "struct", "switch", "this", "throw", "true", "try", "typeof", "uint", "ulong", "unchecked",
+			"unsafe", "ushort", "using", "using static", "void", "volatile", "while"
 		};
 
 		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
 
-		language.isPunctuation = isLuaStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getLuaStyleNumber;
+		compileCStyleLexer(language.lexer, csStyleNumber, cStylePunctuation);
 		initialized = true;
 	}
 
@@ -6814,270 +6875,73 @@ const TextEditor::Language* TextEditor::Language::Lua() {
 
 
 //
-//	getPythonStyleNumber
+//	TextEditor::Language::AngelScript
 //
 
-static TextEditor::Iterator getPythonStyleNumber(TextEditor::Iterator start, TextEditor::Iterator end) {
-	TextEditor::Iterator i = start;
-	TextEditor::Iterator marker;
+const TextEditor::Language* TextEditor::Language::AngelScript() {
+	static bool initialized = false;
+	static TextEditor::Language language;
 
-	
-{
-	ImWchar yych;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0': goto yy2;
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy4;
-		default:
-			if (i >= end) goto yy18;
-			goto yy1;
-	}
-yy1:
-	++i;
-	{ return start; }
-yy2:
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 0x00: goto yy3;
-		case 'B':
-		case 'b': goto yy9;
-		case 'O':
-		case 'o': goto yy11;
-		case 'X':
-		case 'x': goto yy12;
-		default: goto yy5;
-	}
-yy3:
-	{
-			return i;
-		}
-yy4:
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-yy5:
-	switch (yych) {
-		case '+':
-		case '-':
-		case 'E':
-		case 'e': goto yy6;
-		case '.': goto yy8;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy4;
-		case 'J':
-		case 'j': goto yy10;
-		default: goto yy3;
-	}
-yy6:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy13;
-		default: goto yy7;
-	}
-yy7:
-	i = marker;
-	goto yy3;
-yy8:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy14;
-		default: goto yy7;
-	}
-yy9:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '_': goto yy15;
-		default: goto yy7;
-	}
-yy10:
-	++i;
-	goto yy3;
-yy11:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '_': goto yy16;
-		default: goto yy7;
-	}
-yy12:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case '_':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy17;
-		default: goto yy7;
-	}
-yy13:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy13;
-		case 'J':
-		case 'j': goto yy10;
-		default: goto yy3;
-	}
-yy14:
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-':
-		case 'E':
-		case 'e': goto yy6;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '_': goto yy14;
-		case 'J':
-		case 'j': goto yy10;
-		default: goto yy3;
-	}
-yy15:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '_': goto yy15;
-		default: goto yy3;
-	}
-yy16:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '_': goto yy16;
-		default: goto yy3;
-	}
-yy17:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-		case '_':
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f': goto yy17;
-		default: goto yy3;
+	if (!initialized) {
+		language.name = "AngelScript";
+		language.preprocess = '#';
+		language.singleLineComment = "//";
+		language.commentStart = "/*";
+		language.commentEnd = "*/";
+		language.hasSingleQuotedStrings = true;
+		language.hasDoubleQuotedStrings = true;
+		language.stringEscape = '\\';
+
+		static const char* const keywords[] = {
+			"and", "abstract", "auto", "bool", "break", "case", "cast", "class", "const", "continue", "default",
+			"do", "double", "else", "enum", "false", "final", "float", "for", "from", "funcdef", "function", "get",
+			"if", "import", "in", "inout", "int", "interface", "int8", "int16", "int32", "int64", "is", "mixin",
+			"namespace", "not", "null", "or", "out", "override", "private", "protected", "return", "set", "shared",
+			"super", "switch", "this ", "true", "typedef", "uint", "uint8", "uint16", "uint32", "uint64", "void",
+			"while", "xor", "foreach", "nodiscard"
+		};
+
+		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
+
+		compileCStyleLexer(language.lexer, cStyleNumber, cStylePunctuation);
+		initialized = true;
 	}
-yy18:
-	{ return start; }
+
+	return &language;
 }
 
+
+//
+//	TextEditor::Language::Lua
+//
+
+const TextEditor::Language* TextEditor::Language::Lua() {
+	static bool initialized = false;
+	static TextEditor::Language language;
+
+	if (!initialized) {
+		language.name = "Lua";
+		language.singleLineComment = "--";
+		language.commentStart = "--[[";
+		language.commentEnd = "]]";
+		language.hasSingleQuotedStrings = true;
+		language.hasDoubleQuotedStrings = true;
+		language.otherStringStart = "[[";
+		language.otherStringEnd = "]]";
+		language.stringEscape = '\\';
+
+		static const char* const keywords[] = {
+			"and", "break", "do", "else", "elseif", "end", "false", "for", "function", "goto", "if", "in", "local", "nil",
+			"not", "or", "repeat", "return", "then", "true", "until", "while"
+		};
+
+		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
+
+		compileCStyleLexer(language.lexer, luaStyleNumber, luaStylePunctuation);
+		initialized = true;
+	}
+
+	return &language;
 }
 
 
@@ -7109,9 +6973,7 @@ const TextEditor::Language* TextEditor::Language::Python() {
 
 		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
 
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getPythonStyleNumber;
+		compileCStyleLexer(language.lexer, pythonStyleNumber, cStylePunctuation);
 		initialized = true;
 	}
 
@@ -7163,9 +7025,7 @@ const TextEditor::Language* TextEditor::Language::Glsl() {
 
 		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
 
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getCStyleNumber;
+		compileCStyleLexer(language.lexer, cStyleNumber, cStylePunctuation);
 		initialized = true;
 	}
 
@@ -7220,9 +7080,7 @@ const TextEditor::Language* TextEditor::Language::Hlsl() {
 
 		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
 
-		language.isPunctuation = isCStylePunctuation;
-		language.getIdentifier = getCStyleIdentifier;
-		language.getNumber = getCStyleNumber;
+		compileCStyleLexer(language.lexer, cStyleNumber, cStylePunctuation);
 		initialized = true;
 	}
 
@@ -7230,279 +7088,6 @@ const TextEditor::Language* TextEditor::Language::Hlsl() {
 }
 
 
-//
-//	tokenizeJson
-//
-
-static TextEditor::Iterator tokenizeJson(TextEditor::Iterator start, TextEditor::Iterator end, TextEditor::Color& color) {
-	TextEditor::Iterator i = start;
-	TextEditor::Iterator marker;
-
-	
-{
-	ImWchar yych;
-	unsigned int yyaccept = 0;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case ',':
-		case ':':
-		case '[':
-		case ']':
-		case '{':
-		case '}': goto yy3;
-		case '-': goto yy4;
-		case '0': goto yy5;
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy7;
-		case 'f': goto yy8;
-		case 'n': goto yy9;
-		case 't': goto yy10;
-		default:
-			if (i >= end) goto yy24;
-			goto yy1;
-	}
-yy1:
-	++i;
-yy2:
-	{ return start; }
-yy3:
-	++i;
-	{
-			color = TextEditor::Color::punctuation;
-			return i;
-		}
-yy4:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0': goto yy5;
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy7;
-		default: goto yy2;
-	}
-yy5:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy11;
-		case 'E':
-		case 'e': goto yy13;
-		default: goto yy6;
-	}
-yy6:
-	{
-			color = TextEditor::Color::number;
-			return i;
-		}
-yy7:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '.': goto yy11;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy7;
-		case 'E':
-		case 'e': goto yy13;
-		default: goto yy6;
-	}
-yy8:
-	yyaccept = 1;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'a': goto yy14;
-		default: goto yy2;
-	}
-yy9:
-	yyaccept = 1;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'u': goto yy15;
-		default: goto yy2;
-	}
-yy10:
-	yyaccept = 1;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'r': goto yy16;
-		default: goto yy2;
-	}
-yy11:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy17;
-		default: goto yy12;
-	}
-yy12:
-	i = marker;
-	if (yyaccept == 0) goto yy6;
-	else goto yy2;
-yy13:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '+':
-		case '-': goto yy18;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy19;
-		default: goto yy12;
-	}
-yy14:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy20;
-		default: goto yy12;
-	}
-yy15:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy21;
-		default: goto yy12;
-	}
-yy16:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'u': goto yy22;
-		default: goto yy12;
-	}
-yy17:
-	yyaccept = 0;
-	++i;
-	marker = i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy17;
-		case 'E':
-		case 'e': goto yy13;
-		default: goto yy6;
-	}
-yy18:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy19;
-		default: goto yy12;
-	}
-yy19:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9': goto yy19;
-		default: goto yy6;
-	}
-yy20:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 's': goto yy22;
-		default: goto yy12;
-	}
-yy21:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'l': goto yy23;
-		default: goto yy12;
-	}
-yy22:
-	++i;
-	yych = i < end ? *i : 0;
-	switch (yych) {
-		case 'e': goto yy23;
-		default: goto yy12;
-	}
-yy23:
-	++i;
-	{
-			color = TextEditor::Color::identifier;
-			return i;
-		}
-yy24:
-	{ return start; }
-}
-
-}
-
-
 //
 //	TextEditor::Language::Json
 //
@@ -7522,7 +7107,10 @@ const TextEditor::Language* TextEditor::Language::Json() {
 
 		for (auto& keyword : keywords) { language.keywords.insert(keyword); }
 
-		language.customTokenizer = tokenizeJson;
+		language.lexer.addRule(jsonNumber, TextEditor::Color::number);
+		language.lexer.addRule("true|false|null", TextEditor::Color::identifier);
+		language.lexer.addRule("[,:\\[\\]{}]", TextEditor::Color::punctuation);
+		language.lexer.compile();
 		initialized = true;
 	}
 
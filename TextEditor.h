@@ -16,9 +16,11 @@
 #include <array>
 #include <functional>
 #include <iterator>
+#include <list>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -44,7 +46,7 @@ public:
 	inline int GetTabSize() const { return document.getTabSize(); }
 	inline void SetLineSpacing(float value) { lineSpacing = std::max(1.0f, std::min(2.0f, value)); }
 	inline float GetLineSpacing() const { return lineSpacing; }
-	inline void SetReadOnlyEnabled(bool value) { readOnly = value; }
+	inline void SetReadOnlyEnabled(bool value) { readOnly = value; if (!readOnly && document.isLazy()) setText(document.getText()); }
 	inline bool IsReadOnlyEnabled() const { return readOnly; }
 	inline void SetAutoIndentEnabled(bool value) { autoIndent = value; }
 	inline bool IsAutoIndentEnabled() const { return autoIndent; }
@@ -58,6 +60,12 @@ public:
 	inline bool IsCompletingPairedGlyphs() const { return completePairedGlyphs; }
 	inline void SetOverwriteEnabled(bool value) { overwrite = value; }
 	inline bool IsOverwriteEnabled() const { return overwrite; }
+	inline void SetFoldingEnabled(bool value) { folding = value; foldingChanged = true; }
+	inline bool IsFoldingEnabled() const { return folding; }
+	inline void SetWordWrapEnabled(bool value) { wordWrap = value; wordWrapChanged = true; }
+	inline bool IsWordWrapEnabled() const { return wordWrap; }
+	inline void SetShowMinimapEnabled(bool value) { showMinimap = value; minimapChanged = true; }
+	inline bool IsShowMinimapEnabled() const { return showMinimap; }
 
 	// access text (using UTF-8 encoded strings)
 	// (see note below on cursor and scroll manipulation after setting new text)
@@ -66,6 +74,14 @@ public:
 	inline bool IsEmpty() const { return document.size() == 1 && document[0].size() == 0; }
 	inline int GetLineCount() const { return document.lineCount(); }
 
+	// large file support (read-only editors only)
+	// text of at least this many bytes is only indexed when it is set, lines are decoded and colorized when they scroll into view
+	// bracket matching, folding and word wrap are disabled and searches only see lines that are currently decoded
+	// lines are colorized in the state the line above them was left in, which is unknown until that line has been shown
+	inline void SetLargeFileThreshold(size_t bytes) { largeFileThreshold = bytes; }
+	inline size_t GetLargeFileThreshold() const { return largeFileThreshold; }
+	inline bool IsLargeFile() const { return document.isLazy(); }
+
 	// render the text editor in a Dear ImGui context
 	inline void Render(const char* title, const ImVec2& size=ImVec2(), bool border=false) { render(title, size, border); }
 
@@ -145,11 +161,25 @@ public:
 	inline void FindNext() { findNext(); }
 	inline void FindAll() { findAll(); }
 
+	// code folding (line numbers are zero-based)
+	// folds are based on bracket pairs that span multiple lines and are reset when the document changes
+	inline void ToggleFold(int line) { layout.toggle(line); }
+	inline void FoldAll() { layout.foldAll(); }
+	inline void UnfoldAll() { layout.unfoldAll(); }
+	inline bool IsLineFoldable(int line) const { return layout.isFoldable(line); }
+	inline bool IsLineFolded(int line) const { return layout.isFolded(line); }
+	inline bool IsLineHidden(int line) const { return layout.isHidden(line); }
+
 	// access markers (line numbers are zero-based)
 	inline void AddMarker(int line, ImU32 lineNumberColor, ImU32 textColor, const std::string_view& lineNumberTooltip, const std::string_view& textTooltip) { addMarker(line, lineNumberColor, textColor, lineNumberTooltip, textTooltip); }
 	inline void ClearMarkers() { clearMarkers(); }
 	inline bool HasMarkers() const { return markers.size() != 0; }
 
+	// access minimap highlights (line numbers are zero-based)
+	// markers and cursors are shown automatically, highlights are for everything else (e.g. breakpoints)
+	inline void AddMinimapHighlight(int line, ImU32 color) { minimapHighlights.emplace_back(line, color); }
+	inline void ClearMinimapHighlights() { minimapHighlights.clear(); }
+
 	// line-based decoration
 	struct Decorator {
 		int line; // zero-based
@@ -165,6 +195,25 @@ public:
 	inline void ClearLineDecorator() { SetLineDecorator(0.0f, nullptr); }
 	inline bool HasLineDecorator() const { return decoratorWidth > 0.0f && decoratorCallback != nullptr; }
 
+	// end-of-line annotations (text rendered after the end of a line, e.g. inline values)
+	// the callback is called for every visible line and returns the text to render (empty to skip)
+	// the returned text must stay valid until the line is rendered
+	inline void SetLineAnnotator(std::function<std::string_view(int line)> callback) { annotatorCallback = callback; }
+	inline void ClearLineAnnotator() { SetLineAnnotator(nullptr); }
+	inline bool HasLineAnnotator() const { return annotatorCallback != nullptr; }
+
+	// get the identifiers on a line as colored by the language's tokenizer (line numbers are zero-based)
+	// identifiers that follow a '.' are members of something else and are skipped
+	inline void GetLineIdentifiers(int line, std::vector<std::string>& identifiers) const { getLineIdentifiers(line, identifiers); }
+
+	// hover support (line numbers are zero-based)
+	// returns true if the mouse has rested on a glyph in the text for a short while
+	inline bool GetHoverLocation(int& line, int& column) const { line = hoverLocation.line; column = hoverLocation.column; return hoverReady; }
+
+	// get the identifier at the specified location, plus the member chain leading up to it
+	// (i.e. hovering 'b' in 'a.b.c' returns "a.b"); returns an empty string if there is no identifier
+	inline std::string GetExpressionAt(int line, int column) const { return getExpressionAt(line, column); }
+
 	// setup context menu callbacks (these are called when a user right clicks line numbers or somewhere in the text)
 	// the editor sets up the popup menus, the callback has to populate them
 	inline void SetLineNumberContextMenuCallback(std::function<void(int line)> callback) { lineNumberContextMenuCallback = callback; }
@@ -277,6 +326,47 @@ public:
 		Glyph* glyph;
 	};
 
+	// table-driven lexer: token rules are compiled into a single DFA over codepoints, so matching a token
+	// is a loop over a transition table instead of calls through tokenizer functions
+	class Lexer {
+	public:
+		// add a token rule; when rules match the same length, the one added first wins
+		// patterns support literals, '.', [...] and [^...] sets with ranges, (...), '|', '*', '+', '?'
+		// and the escapes \d (digit), \w (word), \s (whitespace), \i (XID start) and \c (XID continue)
+		// NOTE: patterns must be ASCII; non-ASCII codepoints can only be matched through '.', \i, \c and [^...]
+		void addRule(const std::string_view& pattern, Color color);
+
+		// compile the rules into the DFA (must be called after the last rule is added)
+		void compile();
+
+		// find the longest token at the start of the range (returns start if no rule matches)
+		Iterator match(Iterator start, Iterator end, Color& color) const;
+
+		inline bool empty() const { return transitions.empty(); }
+
+	private:
+		class Compiler;
+
+		// character classes: one atom per ASCII codepoint and three for non-ASCII codepoints
+		// (XID start, XID continue but not start, everything else)
+		static constexpr size_t atoms = 131;
+
+		struct Rule {
+			std::string pattern;
+			Color color;
+		};
+
+		std::vector<Rule> rules;
+		std::array<uint8_t, atoms> classes{};
+		size_t classCount = 0;
+
+		// state * classCount + class -> next state (state 0 is the dead state, state 1 is the start)
+		std::vector<uint16_t> transitions;
+
+		// state -> index of accepted rule (or -1)
+		std::vector<int16_t> accepts;
+	};
+
 	// language support
 	class Language {
 	public:
@@ -326,6 +416,10 @@ public:
 		std::function<Iterator(Iterator start, Iterator end)> getIdentifier;
 		std::function<Iterator(Iterator start, Iterator end)> getNumber;
 
+		// table-driven alternative to getIdentifier, getNumber and isPunctuation (used instead of them when compiled)
+		// identifier tokens (colored Color::identifier) are still checked against the keyword and identifier sets
+		Lexer lexer;
+
 		// function to implement custom tokonizer
 		// if a token is found function should return the an iterator to the character after the token
 		// and set the color
@@ -344,11 +438,47 @@ public:
 		static const Language* Markdown();
 	};
 
+	// identifiers (and their colors) that aren't part of the language itself, such as types and functions
+	// provided by an application; lookups go straight from glyphs, so colorizing doesn't have to allocate
+	// NOTE: identifiers must be ASCII
+	class Identifiers {
+	public:
+		// add an identifier (later additions replace earlier ones)
+		void insert(const std::string_view& identifier, Color color);
+		void clear();
+
+		// see if the glyphs in the specified range form a known identifier
+		bool find(Iterator start, Iterator end, Color& color) const;
+
+		inline size_t size() const { return count; }
+		inline bool empty() const { return count == 0; }
+
+	private:
+		struct Slot {
+			uint32_t hash;
+			uint32_t offset;
+			uint16_t length = 0;
+			Color color;
+		};
+
+		template <typename T>
+		static uint32_t hash(T start, T end);
+
+		std::string text;
+		std::vector<Slot> slots;
+		size_t count = 0;
+	};
+
 	inline void SetLanguage(const Language* l) { language = l; languageChanged = true; }
 	inline const Language* GetLanguage() const { return language; };
 	inline bool HasLanguage() const { return language != nullptr; }
 	inline std::string GetLanguageName() const { return language == nullptr ? "None" : language->name; }
 
+	// identifiers colored on top of the language's own (the set must outlive the editor, or be reset);
+	// call this again after changing the set to recolorize the document
+	inline void SetIdentifiers(const Identifiers* i) { colorizer.identifiers = i; languageChanged = true; }
+	inline const Identifiers* GetIdentifiers() const { return colorizer.identifiers; }
+
 	// support functions for unicode codepoints
 	class CodePoint {
 	public:
@@ -515,9 +645,10 @@ private:
 	// the list of text markers
 	class Marker {
 	public:
-		Marker(ImU32 lc, ImU32 tc, const std::string_view& lt, const std::string_view& tt) :
-			lineNumberColor(lc), textColor(tc), lineNumberTooltip(lt), textTooltip(tt) {}
+		Marker(int l, ImU32 lc, ImU32 tc, const std::string_view& lt, const std::string_view& tt) :
+			line(l), lineNumberColor(lc), textColor(tc), lineNumberTooltip(lt), textTooltip(tt) {}
 
+		int line;
 		ImU32 lineNumberColor;
 		ImU32 textColor;
 		std::string lineNumberTooltip;
@@ -536,6 +667,10 @@ private:
 		inOtherStringAlt
 	};
 
+	// minimap resolution (the minimap summarizes this many columns of each line)
+	static constexpr int minimapBuckets = 24;
+	static constexpr int minimapColumns = 4;
+
 	// a single line in a document
 	class Line : public std::vector<Glyph> {
 	public:
@@ -550,6 +685,25 @@ private:
 
 		// do we need to (re)colorize this line
 		bool colorize = true;
+
+		// incremented every time the line's text changes
+		int version = 0;
+
+		// dominant color for each group of minimapColumns columns (background if empty)
+		std::array<Color, minimapBuckets> minimap;
+
+		// do we need to update the minimap summary for this line
+		bool updateMinimap = true;
+
+		// have the glyphs been decoded (only false for large files)
+		bool decoded = true;
+
+		// word wrap cache (first column of each continuation row)
+		// (only valid for the version, wrap width and tab size it was built with)
+		int wrapVersion = -1;
+		int wrapWidth = 0;
+		int wrapTabSize = 0;
+		std::vector<int> wrapColumns;
 	};
 
 	// the document being edited (Lines of Glyphs)
@@ -567,6 +721,20 @@ private:
 		Coordinate insertText(Coordinate start, const std::string_view& text);
 		void deleteText(Coordinate start, Coordinate end);
 
+		// replace many sections with the same text in a single sweep over the document
+		// (sections must be sorted and can't overlap); on return, start and end are where each section was
+		// when the edits are applied one after the other and insertEnd is the end of its new text
+		struct Replacement {
+			Coordinate start;
+			Coordinate end;
+			Coordinate insertEnd;
+		};
+
+		void replaceSections(std::vector<Replacement>& replacements, const std::string_view& text);
+
+		// replace the content of the specified lines in place (text has a newline terminated entry for each line)
+		void replaceLines(const std::vector<int>& lines, const std::string_view& text);
+
 		// access document text (strings are UTF-8 encoded)
 		std::string getText() const;
 		std::string getSectionText(Coordinate start, Coordinate end) const;
@@ -604,6 +772,12 @@ private:
 		// see if document was updated this frame (can only be called once)
 		inline bool isUpdated() { auto result = updated; updated = false; return result; }
 
+		// large file support (lines are decoded from the source text when they are needed)
+		void setLazyText(const std::string_view& text);
+		inline bool isLazy() const { return lazy; }
+		bool decodeLine(int line);
+		void releaseLine(int line);
+
 		// utility functions
 		bool isWholeWord(Coordinate start, Coordinate end) const;
 		inline bool isEndOfLine(Coordinate from) const { return getIndex(from) == at(from.line).size(); }
@@ -614,6 +788,10 @@ private:
 		int tabSize = 4;
 		int maxColumn = 0;
 		bool updated = false;
+
+		std::string source;
+		std::vector<size_t> lineOffsets; // start of each line in the source (followed by the end of the source)
+		bool lazy = false;
 	} document;
 
 	// single action to be performed on text as part of a larger transaction
@@ -622,18 +800,24 @@ private:
 		// action types
 		enum class Type : char {
 			insertText,
-			deleteText
+			deleteText,
+			replaceLines
 		};
 
 		// constructors
 		Action() = default;
 		Action(Type t, Coordinate s, Coordinate e, const std::string_view& txt) : type(t), start(s), end(e), text(txt) {}
+		Action(const std::vector<int>& l, const std::string_view& before, const std::string_view& after) : type(Type::replaceLines), text(before), lines(l), replacement(after) {}
 
 		// properties
 		Type type;
 		Coordinate start;
 		Coordinate end;
 		std::string text;
+
+		// replaced lines with their text before (in text) and after (in replacement), each line ending in a newline
+		std::vector<int> lines;
+		std::string replacement;
 	};
 
 	// a collection of actions for a complete transaction
@@ -648,6 +832,7 @@ private:
 		// add actions by type
 		void addInsert(Coordinate start, Coordinate end, std::string_view text) { emplace_back(Action::Type::insertText, start, end, text); };
 		void addDelete(Coordinate start, Coordinate end, std::string_view text) { emplace_back(Action::Type::deleteText, start, end, text); };
+		void addReplaceLines(const std::vector<int>& lines, std::string_view before, std::string_view after) { emplace_back(lines, before, after); };
 
 		// get number of actions
 		inline int actions() const { return static_cast<int>(size()); }
@@ -690,6 +875,10 @@ private:
 
 		// update colors in changed lines in specified document
 		void updateChangedLines(Document& document, const Language* language);
+		void updateChangedLines(Document& document, const Language* language, int first, int last);
+
+		// extra identifiers to color (if any)
+		const Identifiers* identifiers = nullptr;
 
 	private:
 		// update color in a single line
@@ -700,6 +889,9 @@ private:
 
 		// set color fofr specified range of glyphs
 		inline void setColor(Line::iterator start, Line::iterator end, Color color) { while (start < end) (start++)->color = color; }
+
+		// text of the identifier being looked up
+		std::string identifier;
 	} colorizer;
 
 	// details about bracketed text
@@ -746,9 +938,96 @@ private:
 		Coordinate activeLocation = Coordinate::invalid();
 	} bracketeer;
 
+	// layout of document lines into visible rows (code folding and word wrap)
+	// folding a bracket pair hides the lines between its opening and closing lines
+	// a wrapped line takes up multiple rows
+	// a Fenwick tree over the rows per line maps document lines to visible rows (and back) in O(log n)
+	class Layout {
+	public:
+		// reset to the specified number of single row lines with nothing foldable
+		void reset(int lines);
+
+		// rebuild the foldable ranges from the bracket pairs (this unfolds everything)
+		void update(const Bracketeer& bracketeer, int lines);
+
+		// access fold state
+		inline bool isFoldable(int line) const { return line >= 0 && line < lineCount && ends[line] >= 0; }
+		inline bool isFolded(int line) const { return isFoldable(line) && folded[line]; }
+		inline bool isHidden(int line) const { return hidden && line >= 0 && line < lineCount && covers[line] > 0; }
+
+		// change fold state
+		void fold(int line);
+		void unfold(int line);
+		inline void toggle(int line) { if (isFolded(line)) unfold(line); else fold(line); }
+		void foldAll();
+		void unfoldAll();
+
+		// unfold everything that hides the specified line
+		void reveal(int line);
+
+		// access the number of rows a line takes up when it is visible
+		void setRows(int line, int count);
+		inline int getRows(int line) const { return (line >= 0 && line < lineCount) ? rows[line] : 1; }
+
+		// translate between document lines and visible rows
+		// (getRow returns a line's first row and a hidden line maps to the row of the next visible line)
+		inline int getRow(int line) const { return isUniform() ? line : prefix(line); }
+		int getLine(int row) const;
+		inline int getRowCount() const { return rowCount; }
+
+		// get the next visible line after the specified line (returns the line count at the end)
+		inline int getNextVisibleLine(int line) const { return isUniform() ? line + 1 : getLine(getRow(line) + (isHidden(line) ? 0 : getRows(line))); }
+
+	private:
+		// see if every line maps to exactly one row
+		inline bool isUniform() const { return !hidden && !extraRows; }
+
+		// hide/show the lines covered by a fold
+		void cover(int line, int delta);
+
+		// Fenwick tree operations (visible rows for lines in [0, line))
+		void add(int line, int delta);
+		int prefix(int line) const;
+
+		std::vector<int> ends; // last line of the fold starting on each line (-1 if none)
+		std::vector<bool> folded;
+		std::vector<int> covers; // number of folds hiding each line
+		std::vector<int> rows;
+		std::vector<int> tree;
+		std::vector<int> foldedLines;
+		int lineCount = 0;
+		int rowCount = 0;
+		int hidden = 0;
+		int extraRows = 0;
+	} layout;
+
 	// set the editor's text
 	void setText(const std::string_view& text);
 
+	// minimap support
+	void summarizeLine(Line& line);
+	void renderMinimap();
+
+	// large file support
+	void decodeVisibleLines();
+
+	// word wrap support
+	inline bool isWrapping() const { return wordWrap && !document.isLazy(); }
+	void updateWordWrap();
+	void wrapLine(Line& line);
+	const std::vector<int>& getWrapColumns(int line) const;
+	int getWrapRow(int line, int column) const;
+	int getWrapRowStart(int line, int row) const;
+	int getWrapRowEnd(int line, int row) const;
+	ImVec2 getTextPosition(Coordinate coordinate) const;
+	Coordinate getMouseCoordinate(int row, float x, bool glyph) const;
+
+	// get the identifiers on a line
+	void getLineIdentifiers(int line, std::vector<std::string>& identifiers) const;
+
+	// get the expression at a location
+	std::string getExpressionAt(int line, int column) const;
+
 	// render (parts of) the text editor
 	void render(const char* title, const ImVec2& size, bool border);
 	void renderSelections();
@@ -758,6 +1037,7 @@ private:
 	void renderCursors();
 	void renderMargin();
 	void renderLineNumbers();
+	void renderFolds();
 	void renderDecorations();
 	void renderFindReplace(ImVec2 pos, ImVec2 available);
 
@@ -843,6 +1123,7 @@ private:
 	void filterLines(std::function<std::string(std::string_view)> filter);
 	void tabsToSpaces();
 	void spacesToTabs();
+	void replaceLines(const std::vector<int>& lines, const std::vector<std::string>& replacements);
 
 	// transaction functions
 	// note that strings must be UTF-8 encoded
@@ -851,6 +1132,7 @@ private:
 
 	void insertTextIntoAllCursors(std::shared_ptr<Transaction> transaction, const std::string_view& text);
 	void deleteTextFromAllCursors(std::shared_ptr<Transaction> transaction);
+	bool replaceTextInAllCursors(std::shared_ptr<Transaction> transaction, const std::string_view& text, const std::vector<Document::Replacement>* sections=nullptr);
 	void autoIndentAllCursors(std::shared_ptr<Transaction> transaction);
 	Coordinate insertText(std::shared_ptr<Transaction> transaction, Coordinate start, const std::string_view& text);
 	void deleteText(std::shared_ptr<Transaction> transaction, Coordinate start, Coordinate end);
@@ -864,6 +1146,9 @@ private:
 	bool showMatchingBrackets = true;
 	bool completePairedGlyphs = true;
 	bool overwrite = false;
+	bool folding = false;
+	bool wordWrap = false;
+	bool showMinimap = false;
 
 	// rendering context
 	ImFont* font;
@@ -871,26 +1156,56 @@ private:
 	ImVec2 glyphSize;
 	float lineNumberLeftOffset;
 	float lineNumberRightOffset;
+	float foldOffset;
 	float decorationOffset;
 	float textOffset;
 	float visibleHeight;
 	int visibleLines;
 	int firstVisibleLine;
 	int lastVisibleLine;
+	int firstVisibleRow = 0;
+	int lastVisibleRow = 0;
 	float visibleWidth;
 	int visibleColumns;
 	int firstVisibleColumn;
 	int lastVisibleColumn;
+	int wrapWidth = 0;
+	int wrapTabSize = 0;
+	float minimapWidth = 0.0f;
 	float cursorAnimationTimer = 0.0f;
 	bool ensureCursorIsVisible = false;
 	int scrollToLineNumber = -1;
 	Scroll scrollToAlignment = Scroll::alignMiddle;
 	bool showMatchingBracketsChanged = false;
 	bool languageChanged = false;
+	bool foldingChanged = false;
+	bool wordWrapChanged = false;
+	bool minimapChanged = false;
+	bool minimapDragging = false;
+
+	// cached minimap rectangles (rebuilt when the document, its colors or the minimap size changes)
+	struct MinimapRect {
+		int row;
+		int firstBucket;
+		int lastBucket;
+		Color color;
+	};
+
+	std::vector<MinimapRect> minimapRects;
+	int minimapRows = 0;
+	std::vector<std::pair<int, ImU32>> minimapHighlights;
+
+	// decoded lines in large files (most recently used first)
+	std::list<int> decodedLines;
+	std::unordered_map<int, std::list<int>::iterator> decodedLineIndex;
+	size_t largeFileThreshold = 0;
+	static constexpr size_t decodedLineLimit = 4096;
 
 	float decoratorWidth = 0.0f;
 	std::function<void(Decorator&)> decoratorCallback;
 
+	std::function<std::string_view(int line)> annotatorCallback;
+
 	std::function<void(int line)> lineNumberContextMenuCallback;
 	std::function<void(int line, int column)> textContextMenuCallback;
 	int contextMenuLine = 0;
@@ -900,6 +1215,7 @@ private:
 	static constexpr int decorationMargin = 1;
 	static constexpr int textMargin = 2;
 	static constexpr int cursorWidth = 1;
+	static constexpr float hoverDelay = 0.5f; // in seconds
 
 	// find and replace support
 	std::string findButtonLabel = "Find";
@@ -916,6 +1232,9 @@ private:
 
 	// interaction context
 	float lastClickTime = -1.0f;
+	Coordinate hoverLocation = Coordinate::invalid();
+	float hoverStartTime = 0.0f;
+	bool hoverReady = false;
 	ImWchar completePairCloser = 0;
 	Coordinate completePairLocation;
 
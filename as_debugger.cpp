@@ -5,6 +5,12 @@
 #include <angelscript.h>
 #include "as_debugger.h"
 #include <bitset>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <cctype>
+#include <cstring>
 
 /*virtual*/ const asIDBVarAddr &asIDBVarView::GetID() /*override*/
 {
@@ -73,6 +79,8 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
     // *(object + compositeOffset) + offset
     if (isCompositeIndirect)
     {
+        RecordExprRead(reinterpret_cast<uint8_t *>(id.resolved) + compositeOffset);
+
         void *propAddr = *reinterpret_cast<uint8_t **>(reinterpret_cast<uint8_t *>(id.resolved) + compositeOffset);
 
         // if we're null, leave it alone, otherwise point to
@@ -117,6 +125,7 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
         ctx->GetVar(offset, stack_index, 0, &variable_key.typeId, &modifiers);
         variable_key.constant = (modifiers & asTM_CONST) != 0;
         variable_key.address = ctx->GetAddressOfVar(offset, stack_index);
+        RecordExprRoot(asIDBExprRoot::Local, offset, variable_key.address);
     }
     // check this
     else if (variable_name == "this")
@@ -125,6 +134,7 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
             return std::nullopt;
 
         variable_key.typeId = ctx->GetThisTypeId(stack_index);
+        RecordExprRoot(asIDBExprRoot::This, 0, variable_key.address);
     }
     else
     {
@@ -147,6 +157,7 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
 
             variable_key.typeId = typeId;
             variable_key.address = ctx->GetAddressOfVar(i, stack_index);
+            RecordExprRoot(asIDBExprRoot::Local, i, variable_key.address);
             break;
         }
 
@@ -174,6 +185,7 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
 
                     variable_key.typeId = typeId;
                     variable_key.constant = isReadOnly;
+                    RecordExprRoot(asIDBExprRoot::Member, i, thisPtr);
                     variable_key.address = ResolvePropertyAddress(asIDBVarAddr { thisTypeId, false, thisPtr }, i, offset, compositeOffset, isCompositeIndirect);
                     break;
                 }
@@ -198,6 +210,7 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
 
                 variable_key.typeId = typeId;
                 variable_key.address = main->GetAddressOfGlobalVar(n);
+                RecordExprRoot(asIDBExprRoot::Global, n, variable_key.address);
                 break;
             }
         }
@@ -228,6 +241,10 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
     else if (!idKey.resolved)
         return std::nullopt;
 
+    // the handle we're going through
+    if (idKey.source.typeId & (asTYPEID_HANDLETOCONST | asTYPEID_OBJHANDLE))
+        RecordExprRead(idKey.source.address);
+
     // check what kind of sub-evaluator to use
     std::string_view eval_name = rest.substr(0, rest.find_first_of(".[", 1));
 
@@ -263,6 +280,76 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
     return std::nullopt;
 }
 
+/*virtual*/ bool asIDBCache::ExprDepsValid(const asIDBExprDeps &deps, int stack_index)
+{
+    if (deps.root == asIDBExprRoot::None || deps.stack_index != stack_index)
+        return false;
+    else if ((asUINT) stack_index >= ctx->GetCallstackSize() || ctx->GetFunction(stack_index) != deps.function)
+        return false;
+    // different locals in scope may shadow the root differently
+    else if (dbg->GetVarsInScope(ctx, stack_index) != deps.scope)
+        return false;
+
+    switch (deps.root)
+    {
+    case asIDBExprRoot::Local:
+        if (ctx->GetAddressOfVar(deps.index, stack_index) != deps.root_address)
+            return false;
+        break;
+    case asIDBExprRoot::This:
+    case asIDBExprRoot::Member:
+        if (ctx->GetThisPointer(stack_index) != deps.root_address)
+            return false;
+        break;
+    case asIDBExprRoot::Global:
+        if (ctx->GetFunction(0)->GetModule()->GetAddressOfGlobalVar(deps.index) != deps.root_address)
+            return false;
+        break;
+    default:
+        return false;
+    }
+
+    // each read is only safe to do if the ones
+    // before it (that led us here) are unchanged.
+    for (auto &[address, value] : deps.reads)
+        if (*reinterpret_cast<void **>(address) != value)
+            return false;
+
+    return true;
+}
+
+/*virtual*/ void asIDBCache::RefreshWatch(asIDBWatchEntry &entry, int stack_index)
+{
+    if (entry.result && ExprDepsValid(entry.deps, stack_index))
+    {
+        // same address, so only the value needs updating; the
+        // old state may refer to the previous cache's variables.
+        entry.result->value = asIDBVarState { evaluators.Evaluate(*this, entry.result->idKey) };
+    }
+    else
+    {
+        entry.deps = {};
+        expr_deps = &entry.deps;
+        entry.result = ResolveExpression(entry.name, stack_index);
+        expr_deps = nullptr;
+
+        if (entry.result)
+        {
+            entry.deps.stack_index = stack_index;
+            entry.deps.function = ctx->GetFunction(stack_index);
+            entry.deps.scope = dbg->GetVarsInScope(ctx, stack_index);
+        }
+    }
+
+    // TODO: modifier passed through resolve expression?
+    if (entry.result)
+        entry.type = GetTypeNameFromType({ entry.result->idKey.typeId });
+    else
+        entry.type = "";
+
+    entry.dirty = false;
+}
+
 /*virtual*/ void asIDBCache::CacheCallstack()
 {
     if (!ctx)
@@ -387,8 +474,14 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
 
     auto &map = locals[stack_entry];
 
+    // variables that aren't in scope yet (or anymore)
+    // only hold garbage, so they're skipped entirely.
+    std::vector<bool> inScope;
+
     if (stack_entry.type == asIDBLocalType::Variable)
     {
+        inScope = dbg->GetVarsInScope(ctx, stack_entry.offset);
+
         if (auto thisPtr = ctx->GetThisPointer(stack_entry.offset))
         {
             int thisTypeId = ctx->GetThisTypeId(stack_entry.offset);
@@ -427,6 +520,8 @@ void *asIDBCache::ResolvePropertyAddress(const asIDBResolvedVarAddr &id, int pro
             continue;
         else if (!isTemporary && (stack_entry.type == asIDBLocalType::Temporary))
             continue;
+        else if ((size_t) n < inScope.size() && !inScope[n])
+            continue;
 
         void *ptr = ctx->GetAddressOfVar(n, stack_entry.offset);
 
@@ -630,6 +725,73 @@ public:
     }
 };
 
+/*virtual*/ bool asIDBStringTypeEvaluator::GetStringView(asIDBCache &cache, const asIDBResolvedVarAddr &id, std::string_view &view, std::string &storage) const
+{
+    auto engine = cache.ctx->GetEngine();
+    asIStringFactory *factory = nullptr;
+    asUINT length = 0;
+
+    if (engine->GetStringFactory(nullptr, &factory) < 0 || !factory ||
+        factory->GetRawStringData(id.resolved, nullptr, &length) < 0)
+        return false;
+
+    storage.resize(length);
+
+    if (factory->GetRawStringData(id.resolved, storage.data(), &length) < 0)
+        return false;
+
+    view = storage;
+    return true;
+}
+
+/*virtual*/ asIDBVarValue asIDBStringTypeEvaluator::Evaluate(asIDBCache &cache, const asIDBResolvedVarAddr &id) const /*override*/
+{
+    std::string_view view;
+    std::string storage;
+
+    if (!GetStringView(cache, id, view, storage))
+        return { "(unknown string)", true };
+
+    asIDBVarValue val;
+    val.truncated = view.size() > previewLength;
+    val.value.reserve(previewLength + 8);
+    val.value.push_back('"');
+
+    // escape anything that would break up the row
+    for (char c : view.substr(0, previewLength))
+    {
+        switch (c)
+        {
+        case '\n': val.value += "\\n"; break;
+        case '\r': val.value += "\\r"; break;
+        case '\t': val.value += "\\t"; break;
+        case '"': val.value += "\\\""; break;
+        case '\\': val.value += "\\\\"; break;
+        default: val.value.push_back(c); break;
+        }
+    }
+
+    val.value.push_back('"');
+
+    if (val.truncated)
+        val.value += fmt::format("... ({} chars)", view.size());
+
+    return val;
+}
+
+/*virtual*/ std::string asIDBStringTypeEvaluator::FetchFullValue(asIDBCache &cache, const asIDBResolvedVarAddr &id) const /*override*/
+{
+    std::string_view view;
+    std::string storage;
+
+    if (!GetStringView(cache, id, view, storage))
+        return {};
+    else if (!storage.empty())
+        return storage;
+
+    return std::string(view);
+}
+
 /*virtual*/ asIDBVarValue asIDBObjectTypeEvaluator::Evaluate(asIDBCache &cache, const asIDBResolvedVarAddr &id) const /*override*/
 {
     auto ctx = cache.ctx;
@@ -943,6 +1105,14 @@ const asIDBTypeEvaluator &asIDBTypeEvaluatorMap::GetEvaluator(asIDBCache &cache,
 
 #undef CHECK_PRIMITIVE_EVAL
 
+    // the registered string type
+    if (int stringTypeId = cache.ctx->GetEngine()->GetStringFactory(); stringTypeId > 0 &&
+        (stringTypeId & (asTYPEID_MASK_OBJECT | asTYPEID_MASK_SEQNBR)) == (id.source.typeId & (asTYPEID_MASK_OBJECT | asTYPEID_MASK_SEQNBR)))
+    {
+        static constexpr const asIDBStringTypeEvaluator stringType;
+        return stringType;
+    }
+
     if (type->GetFlags() & asOBJ_ENUM)
     {
         static constexpr const asIDBEnumTypeEvaluator enumType;
@@ -969,6 +1139,11 @@ void asIDBTypeEvaluatorMap::Expand(asIDBCache &cache, const asIDBResolvedVarAddr
     GetEvaluator(cache, id).Expand(cache, id, state);
 }
 
+std::string asIDBTypeEvaluatorMap::FetchFullValue(asIDBCache &cache, const asIDBResolvedVarAddr &id) const
+{
+    return GetEvaluator(cache, id).FetchFullValue(cache, id);
+}
+
 // Register an evaluator.
 void asIDBTypeEvaluatorMap::Register(int typeId, std::unique_ptr<asIDBTypeEvaluator> evaluator)
 {
@@ -976,19 +1151,154 @@ void asIDBTypeEvaluatorMap::Register(int typeId, std::unique_ptr<asIDBTypeEvalua
     evaluators.insert_or_assign(typeId, std::move(evaluator));
 }
 
+static int64_t asIDBProfileTicks()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void asIDBDebugger::StartProfiling()
+{
+    std::scoped_lock lock(profile.mutex);
+
+    profile.functions.clear();
+    profile.stack.clear();
+    profile.ctx = nullptr;
+    profile.paused = 0;
+    profile.elapsed = 0;
+
+    // the clock read at the start of each callback can't
+    // measure itself, so use the cheapest one we can find.
+    profile.overhead = std::numeric_limits<int64_t>::max();
+
+    for (int i = 0; i < 1000; i++)
+    {
+        int64_t a = asIDBProfileTicks();
+        int64_t b = asIDBProfileTicks();
+        profile.overhead = std::min(profile.overhead, b - a);
+    }
+
+    profile.start = profile.last = asIDBProfileTicks();
+    profiling = true;
+}
+
+void asIDBDebugger::StopProfiling()
+{
+    std::scoped_lock lock(profile.mutex);
+
+    if (!profiling)
+        return;
+
+    profiling = false;
+
+    while (!profile.stack.empty())
+        PopProfileFrame(profile.last);
+
+    profile.elapsed = asIDBProfileTicks() - profile.paused - profile.start;
+}
+
+void asIDBDebugger::PushProfileFrame(asIScriptFunction *func, int64_t now)
+{
+    int id = func ? func->GetId() : -1;
+
+    if (id >= 0)
+    {
+        if ((size_t) id >= profile.functions.size())
+            profile.functions.resize(id + 1);
+
+        auto &fp = profile.functions[id];
+
+        if (fp.name.empty())
+            fp.name = func->GetDeclaration(true, true);
+
+        fp.calls++;
+        fp.active++;
+    }
+
+    profile.stack.push_back({ id, now, 0 });
+}
+
+void asIDBDebugger::PopProfileFrame(int64_t now)
+{
+    asIDBProfileFrame frame = profile.stack.back();
+    profile.stack.pop_back();
+
+    int64_t inclusive = now - frame.enter;
+
+    if (frame.functionId >= 0)
+    {
+        auto &fp = profile.functions[frame.functionId];
+
+        fp.exclusive += inclusive - frame.children;
+
+        if (!--fp.active)
+            fp.inclusive += inclusive;
+    }
+
+    if (!profile.stack.empty())
+        profile.stack.back().children += inclusive;
+}
+
+void asIDBDebugger::ProfileLine(asIScriptContext *ctx)
+{
+    int64_t raw = asIDBProfileTicks();
+    std::scoped_lock lock(profile.mutex);
+
+    // stopped while we were waiting for the lock
+    if (!profiling)
+        return;
+
+    int64_t now = raw - profile.paused;
+
+    // a different context; we can't know when the
+    // old one returned, so close it off at its last line.
+    if (ctx != profile.ctx)
+    {
+        while (!profile.stack.empty())
+            PopProfileFrame(profile.last);
+
+        profile.ctx = ctx;
+    }
+
+    size_t depth = ctx->GetCallstackSize();
+    asIScriptFunction *top = ctx->GetFunction(0);
+
+    // anything deeper than the current stack has returned; if
+    // the top function changed at the same depth, it returned
+    // and another one was called in between lines.
+    while (profile.stack.size() > depth ||
+           (!profile.stack.empty() && profile.stack.size() == depth && (!top || profile.stack.back().functionId != top->GetId())))
+        PopProfileFrame(now);
+
+    while (profile.stack.size() < depth)
+        PushProfileFrame(ctx->GetFunction((asUINT) (depth - 1 - profile.stack.size())), now);
+
+    profile.last = now;
+
+    // don't count our own bookkeeping.
+    profile.paused += (asIDBProfileTicks() - raw) + profile.overhead;
+}
+
 /*static*/ void asIDBDebugger::LineCallback(asIScriptContext *ctx, asIDBDebugger *debugger)
 {
     if (debugger->internal_execution)
         return;
 
+    if (debugger->profiling)
+        debugger->ProfileLine(ctx);
+
     // we might not have an action - functions called from within
     // the debugger will never have this set.
     if (debugger->action != asIDBAction::None)
     {
+        // filtered functions are never stepped into; if a step
+        // lands in one, we keep going until we reach user code.
+        bool filtered = debugger->IsStepFiltered(ctx->GetFunction(0));
+
         // Step Into just breaks on whatever happens to be next.
         if (debugger->action == asIDBAction::StepInto)
         {
-            debugger->DebugBreak(ctx);
+            if (!filtered)
+                debugger->DebugBreak(ctx);
             return;
         }
         // Step Over breaks on the next line that is <= the
@@ -996,7 +1306,12 @@ void asIDBTypeEvaluatorMap::Register(int typeId, std::unique_ptr<asIDBTypeEvalua
         else if (debugger->action == asIDBAction::StepOver)
         {
             if (ctx->GetCallstackSize() <= debugger->stack_size)
-                debugger->DebugBreak(ctx);
+            {
+                if (filtered)
+                    debugger->action = asIDBAction::StepInto;
+                else
+                    debugger->DebugBreak(ctx);
+            }
             return;
         }
         // Step Out breaks on the next line that is < the
@@ -1004,7 +1319,12 @@ void asIDBTypeEvaluatorMap::Register(int typeId, std::unique_ptr<asIDBTypeEvalua
         else if (debugger->action == asIDBAction::StepOut)
         {
             if (ctx->GetCallstackSize() < debugger->stack_size)
-                debugger->DebugBreak(ctx);
+            {
+                if (filtered)
+                    debugger->action = asIDBAction::StepInto;
+                else
+                    debugger->DebugBreak(ctx);
+            }
             return;
         }
     }
@@ -1022,15 +1342,22 @@ void asIDBTypeEvaluatorMap::Register(int typeId, std::unique_ptr<asIDBTypeEvalua
             const char *section = nullptr;
             int row = ctx->GetLineNumber(0, nullptr, &section);
 
-            if (section && debugger->breakpoints.find(asIDBBreakpoint::FileLocation(asIDBBreakpointLocation { section, row })) != debugger->breakpoints.end())
+            if (section && debugger->bound_breakpoints.find(asIDBBreakpointLocation { section, row }) != debugger->bound_breakpoints.end())
                 break_from_bp = true;
-            else
+            else if (auto func = ctx->GetFunction(0); debugger->bound_functions.find(func) != debugger->bound_functions.end())
             {
-                // FIXME: this makes an std::string every time
-                auto func = ctx->GetFunction(0);
+                // function breakpoints are one-shot.
+                debugger->RemoveBreakpoint(asIDBBreakpoint::Function(func->GetName()));
+                break_from_bp = true;
+            }
+            else if (debugger->pending_function_breakpoints)
+            {
+                // no line tables to bind with; this makes
+                // an std::string every time.
                 if (auto f = debugger->breakpoints.find(asIDBBreakpoint::Function(func->GetName())); f != debugger->breakpoints.end())
                 {
                     debugger->breakpoints.erase(f);
+                    debugger->BindBreakpoints();
                     break_from_bp = true;
                 }
             }
@@ -1047,6 +1374,17 @@ void asIDBDebugger::HookContext(asIScriptContext *ctx)
     // the context is being switched?
     if (ctx->GetState() != asEXECUTION_EXCEPTION)
         ctx->SetLineCallback(asFUNCTION(asIDBDebugger::LineCallback), this, asCALL_CDECL);
+
+    // a fresh execution is about to begin, so whatever
+    // was left on the shadow stack returned after the
+    // last line we saw.
+    if (profiling && !ctx->GetCallstackSize())
+    {
+        std::scoped_lock lock(profile.mutex);
+
+        while (!profile.stack.empty())
+            PopProfileFrame(profile.last);
+    }
 }
 
 void asIDBDebugger::DebugBreak(asIScriptContext *ctx)
@@ -1062,13 +1400,23 @@ void asIDBDebugger::DebugBreak(asIScriptContext *ctx)
         std::swap(cache, new_cache);
     }
     HookContext(ctx);
+
+    // time spent broken doesn't count towards the profile.
+    int64_t suspended = asIDBProfileTicks();
     Suspend();
+
+    if (profiling)
+    {
+        std::scoped_lock lock(profile.mutex);
+        // profiling may have been started while we were broken
+        profile.paused += asIDBProfileTicks() - std::max(suspended, profile.start);
+    }
 }
 
 bool asIDBDebugger::HasWork()
 {
     std::scoped_lock lock(mutex);
-    return !breakpoints.empty() && action == asIDBAction::None;
+    return (!breakpoints.empty() || profiling) && action == asIDBAction::None;
 }
 
 // debugger operations; these set the next breakpoint
@@ -1101,31 +1449,1377 @@ void asIDBDebugger::Continue()
 
 bool asIDBDebugger::ToggleBreakpoint(std::string_view section, int line)
 {
+    std::scoped_lock lock(mutex);
+
+    section = InternSection(section);
+
+    // snap to a line that can actually be hit, so that
+    // toggling a blank line or comment still does something.
+    if (auto lines = section_lines.find(section); lines != section_lines.end())
+        if (auto entry = lines->second.FindNearest(line))
+            line = entry->line;
+
     asIDBBreakpoint bp = asIDBBreakpoint::FileLocation({ section, line });
+    bool added;
 
     if (auto f = breakpoints.find(bp); f != breakpoints.end())
     {
         breakpoints.erase(f);
-        return false;
+        added = false;
     }
     else
     {
         breakpoints.insert(bp);
-        return true;
+        added = true;
     }
+
+    BindBreakpoints();
+    return added;
 }
 
-/*virtual*/ void asIDBDebugger::CacheSections(asIScriptModule *module)
+void asIDBDebugger::RemoveBreakpoint(const asIDBBreakpoint &bp)
 {
-    for (asUINT n = 0; n < module->GetFunctionCount(); n++)
+    std::scoped_lock lock(mutex);
+    breakpoints.erase(bp);
+    BindBreakpoints();
+}
+
+void asIDBDebugger::BindBreakpoints()
+{
+    std::scoped_lock lock(mutex);
+
+    bound_breakpoints.clear();
+    bound_functions.clear();
+    pending_function_breakpoints = false;
+
+    for (auto &bp : breakpoints)
     {
-        const char *section = nullptr;
-        module->GetFunctionByIndex(n)->GetDeclaredAt(&section, nullptr, nullptr);
-        EnsureSectionCached(section, section);
+        if (bp.location.index() != 0)
+        {
+            auto &name = std::get<1>(bp.location);
+
+            if (section_lines.empty())
+            {
+                bp.bind_state = asIDBBindState::Pending;
+                pending_function_breakpoints = true;
+                continue;
+            }
+
+            bp.bind_state = asIDBBindState::Unbound;
+
+            for (auto &[section, lines] : section_lines)
+            {
+                for (auto func : lines.functions)
+                {
+                    if (name != func->GetName())
+                        continue;
+
+                    bound_functions.insert(func);
+                    bp.bind_state = asIDBBindState::Bound;
+                }
+            }
+
+            continue;
+        }
+
+        auto &loc = std::get<0>(bp.location);
+
+        // we don't know anything about this section yet, so
+        // we have to trust that the line is correct.
+        if (auto lines = section_lines.find(loc.section); lines == section_lines.end())
+        {
+            bp.bind_state = asIDBBindState::Pending;
+            bp.bound_line = loc.line;
+        }
+        else if (auto entry = lines->second.FindNearest(loc.line))
+        {
+            bp.bind_state = asIDBBindState::Bound;
+            bp.bound_line = entry->line;
+        }
+        else
+        {
+            bp.bind_state = asIDBBindState::Unbound;
+            bp.bound_line = 0;
+            continue;
+        }
+
+        bound_breakpoints.insert(asIDBBreakpointLocation { loc.section, bp.bound_line });
     }
 }
 
-/*virtual*/ void asIDBDebugger::EnsureSectionCached(std::string_view section, std::string_view canonical)
+void asIDBDebugger::ModuleBuilt(asIScriptModule *module)
+{
+    std::scoped_lock lock(mutex);
+
+    CacheSections(module);
+    CacheLines(module);
+    CacheSymbols(module);
+    CacheEngineSymbols(module->GetEngine());
+    BindBreakpoints();
+    module_generation++;
+
+    // function IDs may have been reused
+    step_skip.clear();
+}
+
+std::vector<bool> asIDBDebugger::GetVarsInScope(asIScriptContext *ctx, asUINT stackLevel)
+{
+    int numVars = ctx->GetVarCount(stackLevel);
+    std::vector<bool> inScope(numVars);
+
+    for (int n = 0; n < numVars; n++)
+        inScope[n] = ctx->IsVarInScope(n, stackLevel);
+
+    return inScope;
+}
+
+std::string_view asIDBDebugger::InternSection(std::string_view section)
+{
+    return *section_names.emplace(section).first;
+}
+
+void asIDBDebugger::SetStepFilters(asIDBStepFilterVector filters)
+{
+    std::scoped_lock lock(mutex);
+    step_filters = std::move(filters);
+    step_skip.clear();
+}
+
+// simple glob match; supports * and ?.
+static bool asIDBGlobMatch(std::string_view pattern, std::string_view str)
+{
+    size_t p = 0, s = 0;
+    size_t starP = std::string_view::npos, starS = 0;
+
+    while (s < str.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            p++;
+            s++;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            starP = p++;
+            starS = s;
+        }
+        else if (starP != std::string_view::npos)
+        {
+            p = starP + 1;
+            s = ++starS;
+        }
+        else
+            return false;
+    }
+
+    while (p < pattern.size() && pattern[p] == '*')
+        p++;
+
+    return p == pattern.size();
+}
+
+bool asIDBDebugger::MatchStepFilters(asIScriptFunction *func)
+{
+    const char *section = func->GetScriptSectionName();
+    const char *ns = func->GetNamespace();
+    std::string name;
+
+    if (ns && *ns)
+        name = fmt::format("{}::", ns);
+    if (auto obj = func->GetObjectName())
+        name += fmt::format("{}::", obj);
+    name += func->GetName();
+
+    bool skip = false;
+
+    for (auto &filter : step_filters)
+    {
+        switch (filter.type)
+        {
+        case asIDBStepFilterType::Section:
+            skip = section && asIDBGlobMatch(filter.pattern, section);
+            break;
+        case asIDBStepFilterType::Namespace:
+            skip = ns && asIDBGlobMatch(filter.pattern, ns);
+            break;
+        case asIDBStepFilterType::Function:
+            skip = asIDBGlobMatch(filter.pattern, name);
+            break;
+        }
+
+        if (skip)
+            break;
+    }
+
+    size_t id = func->GetId();
+
+    if (id >= step_skip.size())
+        step_skip.resize(id + 1);
+
+    step_skip[id] = skip ? 2 : 1;
+    return skip;
+}
+
+// a range of functions (or types, whose methods are
+// scanned) in a module to be scanned for sections.
+struct asIDBSectionScanChunk
+{
+    asIScriptModule *module;
+    bool            types;
+    asUINT          start, end;
+};
+
+// returns the sorted, unique section names that the given
+// modules have code in. large sets of modules are split up
+// into chunks that are scanned by worker threads; only read-only
+// queries are made to the engine while this is happening.
+static std::vector<std::string_view> asIDBScanSections(const std::vector<asIScriptModule *> &modules)
+{
+    constexpr asUINT chunkSize = 1024;
+    // not worth starting threads for less than this
+    // many functions + types (i.e. a single module).
+    constexpr size_t parallelThreshold = 32768;
+
+    std::vector<asIDBSectionScanChunk> chunks;
+    size_t total = 0;
+
+    for (auto module : modules)
+    {
+        for (asUINT i = 0; i < module->GetFunctionCount(); i += chunkSize)
+            chunks.push_back({ module, false, i, std::min(i + chunkSize, module->GetFunctionCount()) });
+        for (asUINT i = 0; i < module->GetObjectTypeCount(); i += chunkSize)
+            chunks.push_back({ module, true, i, std::min(i + chunkSize, module->GetObjectTypeCount()) });
+
+        total += module->GetFunctionCount() + module->GetObjectTypeCount();
+    }
+
+    // section names are pooled by the engine, so the
+    // pointers can be deduplicated before comparing strings.
+    auto scanChunk = [](const asIDBSectionScanChunk &chunk, std::vector<const char *> &out) {
+        auto addFunction = [&out](asIScriptFunction *func) {
+            const char *section = nullptr;
+
+            if (func && func->GetDeclaredAt(&section, nullptr, nullptr) >= 0 && section)
+                out.push_back(section);
+        };
+
+        for (asUINT i = chunk.start; i < chunk.end; i++)
+        {
+            if (!chunk.types)
+            {
+                addFunction(chunk.module->GetFunctionByIndex(i));
+                continue;
+            }
+
+            auto type = chunk.module->GetObjectTypeByIndex(i);
+
+            for (asUINT n = 0; n < type->GetMethodCount(); n++)
+                addFunction(type->GetMethodByIndex(n, false));
+        }
+
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    };
+
+    size_t numWorkers = total < parallelThreshold ? 1 : std::min<size_t>(chunks.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::vector<const char *>> results(numWorkers);
+
+    if (numWorkers <= 1)
+    {
+        for (auto &chunk : chunks)
+            scanChunk(chunk, results[0]);
+    }
+    else
+    {
+        std::atomic_size_t nextChunk = 0;
+        std::vector<std::thread> workers;
+
+        for (size_t w = 0; w < numWorkers; w++)
+        {
+            workers.emplace_back([&, w]() {
+                std::vector<const char *> found;
+
+                for (size_t c; (c = nextChunk++) < chunks.size(); )
+                {
+                    scanChunk(chunks[c], found);
+                    results[w].insert(results[w].end(), found.begin(), found.end());
+                    found.clear();
+                }
+            });
+        }
+
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    std::vector<const char *> pointers;
+
+    for (auto &result : results)
+        pointers.insert(pointers.end(), result.begin(), result.end());
+
+    std::sort(pointers.begin(), pointers.end());
+    pointers.erase(std::unique(pointers.begin(), pointers.end()), pointers.end());
+
+    std::vector<std::string_view> names(pointers.begin(), pointers.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    return names;
+}
+
+/*virtual*/ void asIDBDebugger::CacheSections(asIScriptModule *module)
+{
+    for (auto section : asIDBScanSections({ module }))
+        EnsureSectionCached(section, section);
+}
+
+/*virtual*/ void asIDBDebugger::CacheAllSections(asIScriptEngine *engine)
+{
+    std::vector<asIScriptModule *> modules;
+
+    for (asUINT n = 0; n < engine->GetModuleCount(); n++)
+        modules.push_back(engine->GetModuleByIndex(n));
+
+    std::scoped_lock lock(mutex);
+
+    for (auto section : asIDBScanSections(modules))
+        EnsureSectionCached(section, section);
+}
+
+/*virtual*/ void asIDBDebugger::EnsureSectionCached(std::string_view section, std::string_view canonical)
+{
+    // most calls are for sections we already know
+    // about, so skip the interning for those.
+    if (sections.find(section) != sections.end())
+        return;
+
+    sections.insert({ InternSection(section), InternSection(canonical) });
+}
+
+asIDBSectionSet::const_iterator asIDBSectionSet::find(std::string_view section) const
+{
+    auto it = std::lower_bound(begin(), end(), section, [](const value_type &entry, std::string_view section) {
+        return entry.first < section;
+    });
+
+    return (it != end() && it->first == section) ? it : end();
+}
+
+bool asIDBSectionSet::insert(const value_type &entry)
+{
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry.first, [](const value_type &entry, std::string_view section) {
+        return entry.first < section;
+    });
+
+    if (it != entries.end() && it->first == entry.first)
+        return false;
+
+    entries.insert(it, entry);
+    return true;
+}
+
+void asIDBFuzzyIndex::Clear()
+{
+    text.clear();
+    lower.clear();
+    entries.clear();
+}
+
+uint32_t asIDBFuzzyIndex::Add(std::string_view entry)
+{
+    Entry e { (uint32_t) text.size(), (uint32_t) entry.size(), 0 };
+
+    text.append(entry);
+
+    for (char c : entry)
+        lower.push_back((char) std::tolower((unsigned char) c));
+
+    e.mask = Mask({ lower.data() + e.offset, e.length });
+    entries.push_back(e);
+    return (uint32_t) entries.size() - 1;
+}
+
+/*static*/ uint64_t asIDBFuzzyIndex::Mask(std::string_view text)
+{
+    // one bit per letter and digit; everything
+    // else shares the remaining bits.
+    uint64_t mask = 0;
+
+    for (unsigned char c : text)
+    {
+        c = (unsigned char) std::tolower(c);
+
+        if (c >= 'a' && c <= 'z')
+            mask |= 1ull << (c - 'a');
+        else if (c >= '0' && c <= '9')
+            mask |= 1ull << (26 + (c - '0'));
+        else
+            mask |= 1ull << (36 + (c % 28));
+    }
+
+    return mask;
+}
+
+/*static*/ int asIDBFuzzyIndex::Score(std::string_view text, std::string_view lower, std::string_view query)
+{
+    if (query.empty())
+        return 0;
+
+    // find where the first complete match ends...
+    size_t q = 0, end = 0;
+
+    for (size_t i = 0; i < lower.size(); i++)
+    {
+        if (lower[i] == query[q] && ++q == query.size())
+        {
+            end = i + 1;
+            break;
+        }
+    }
+
+    if (q != query.size())
+        return -1;
+
+    // ...then walk back from there to find the tightest start.
+    size_t start = end;
+
+    while (q)
+        if (lower[--start] == query[q - 1])
+            q--;
+
+    // matches on word boundaries and runs of consecutive
+    // matches score higher; gaps score lower.
+    int score = 0;
+    bool consecutive = false;
+
+    for (size_t i = start; i < end; i++)
+    {
+        if (q < query.size() && lower[i] == query[q])
+        {
+            score += 16;
+
+            unsigned char prev = i ? text[i - 1] : ' ';
+
+            if (!std::isalnum(prev) || (std::islower(prev) && std::isupper((unsigned char) text[i])))
+                score += 24;
+            if (consecutive)
+                score += 16;
+
+            consecutive = true;
+            q++;
+        }
+        else
+        {
+            score -= 1;
+            consecutive = false;
+        }
+    }
+
+    // prefer shorter entries
+    return std::max(score - (int) (text.size() / 8), 0);
+}
+
+void asIDBFuzzyIndex::Search(std::string_view query, size_t k, std::vector<Result> &results) const
+{
+    results.clear();
+
+    std::string q;
+
+    for (char c : query)
+        if (c != ' ')
+            q.push_back((char) std::tolower((unsigned char) c));
+
+    uint64_t mask = Mask(q);
+
+    for (uint32_t i = 0; i < entries.size(); i++)
+    {
+        auto &e = entries[i];
+
+        if ((e.mask & mask) != mask)
+            continue;
+
+        int score = Score({ text.data() + e.offset, e.length }, { lower.data() + e.offset, e.length }, q);
+
+        if (score >= 0)
+            results.push_back({ i, score });
+    }
+
+    auto better = [](const Result &a, const Result &b) {
+        return a.score > b.score || (a.score == b.score && a.index < b.index);
+    };
+
+    if (results.size() > k)
+    {
+        std::nth_element(results.begin(), results.begin() + k, results.end(), better);
+        results.resize(k);
+    }
+
+    std::sort(results.begin(), results.end(), better);
+}
+
+void asIDBLineDiff::Compute(std::string_view old_text, std::string_view new_text)
+{
+    edits.clear();
+    removed = added = 0;
+
+    // intern the lines of both texts
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<uint32_t> old_ids, new_ids;
+
+    auto intern = [&ids](std::string_view text, std::vector<uint32_t> &lines) {
+        for (size_t start = 0; ; )
+        {
+            size_t end = text.find('\n', start);
+            std::string_view line = text.substr(start, end == std::string_view::npos ? end : end - start);
+
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            lines.push_back(ids.try_emplace(line, (uint32_t) ids.size()).first->second);
+
+            if (end == std::string_view::npos)
+                break;
+
+            start = end + 1;
+        }
+    };
+
+    intern(old_text, old_ids);
+    intern(new_text, new_ids);
+    old_lines = (uint32_t) old_ids.size();
+    new_lines = (uint32_t) new_ids.size();
+
+    // lines that only one of the texts has can't be in the
+    // common subsequence, so they're left out of the search.
+    std::vector<uint8_t> in_old(ids.size()), in_new(ids.size());
+
+    for (auto id : old_ids)
+        in_old[id] = 1;
+    for (auto id : new_ids)
+        in_new[id] = 1;
+
+    auto compact = [](const std::vector<uint32_t> &lines, const std::vector<uint8_t> &in_other,
+                      std::vector<uint32_t> &shared, std::vector<uint32_t> &index, std::vector<uint8_t> &changed) {
+        shared.clear();
+        index.clear();
+        changed.assign(lines.size(), 1);
+
+        for (uint32_t i = 0; i < lines.size(); i++)
+        {
+            if (in_other[lines[i]])
+            {
+                shared.push_back(lines[i]);
+                index.push_back(i);
+                changed[i] = 0;
+            }
+        }
+    };
+
+    compact(old_ids, in_new, a, index_a, changed_a);
+    compact(new_ids, in_old, b, index_b, changed_b);
+
+    // split the ranges until there's nothing in common; this
+    // uses a stack instead of recursion since inputs can be huge.
+    struct Range
+    {
+        int a0, a1, b0, b1;
+    };
+
+    std::vector<Range> ranges { { 0, (int) a.size(), 0, (int) b.size() } };
+
+    while (!ranges.empty())
+    {
+        auto [a0, a1, b0, b1] = ranges.back();
+        ranges.pop_back();
+
+        // skip the common prefix and suffix
+        while (a0 < a1 && b0 < b1 && a[a0] == b[b0])
+            a0++, b0++;
+        while (a0 < a1 && b0 < b1 && a[a1 - 1] == b[b1 - 1])
+            a1--, b1--;
+
+        int x, y;
+
+        if (a0 == a1 || b0 == b1 || !Split(a0, a1, b0, b1, x, y))
+        {
+            for (int i = a0; i < a1; i++)
+                changed_a[index_a[i]] = 1;
+            for (int i = b0; i < b1; i++)
+                changed_b[index_b[i]] = 1;
+            continue;
+        }
+
+        ranges.push_back({ x, a1, y, b1 });
+        ranges.push_back({ a0, x, b0, y });
+    }
+
+    // turn the marks into runs
+    auto push = [this](Op op, uint32_t old_line, uint32_t new_line, uint32_t count) {
+        if (count)
+            edits.push_back({ op, old_line, new_line, count });
+    };
+
+    for (uint32_t i = 0, j = 0; i < old_lines || j < new_lines; )
+    {
+        uint32_t equal = 0, deleted = 0, inserted = 0;
+
+        while (i + equal < old_lines && j + equal < new_lines && !changed_a[i + equal] && !changed_b[j + equal])
+            equal++;
+
+        push(Op::Equal, i, j, equal);
+        i += equal;
+        j += equal;
+
+        while (i + deleted < old_lines && changed_a[i + deleted])
+            deleted++;
+
+        push(Op::Delete, i, j, deleted);
+        i += deleted;
+
+        while (j + inserted < new_lines && changed_b[j + inserted])
+            inserted++;
+
+        push(Op::Insert, i, j, inserted);
+        j += inserted;
+
+        removed += deleted;
+        added += inserted;
+
+        if (!equal && !deleted && !inserted)
+            break;
+    }
+}
+
+bool asIDBLineDiff::Split(int a0, int a1, int b0, int b1, int &x, int &y)
+{
+    // past this many edits, the search is stopped and the
+    // furthest reaching forward path is used as the split.
+    constexpr int max_cost = 256;
+
+    const int n = a1 - a0, m = b1 - b0;
+    const int delta = n - m;
+    const bool odd = delta & 1;
+    const int max_d = std::min((n + m + 1) / 2, max_cost);
+    const int offset = max_d;
+    const int size = max_d * 2 + 2;
+
+    forward.assign(size, -1);
+    backward.assign(size, -1);
+    forward[offset + 1] = 0;
+    backward[offset + 1] = 0;
+
+    // diagonals that ran off the edges are skipped
+    int forward_start = 0, forward_end = 0, backward_start = 0, backward_end = 0;
+
+    for (int d = 0; d < max_d; d++)
+    {
+        for (int k = -d + forward_start; k <= d - forward_end; k += 2)
+        {
+            int i = offset + k;
+            int x1 = (k == -d || (k != d && forward[i - 1] < forward[i + 1])) ? forward[i + 1] : forward[i - 1] + 1;
+            int y1 = x1 - k;
+
+            while (x1 < n && y1 < m && a[a0 + x1] == b[b0 + y1])
+                x1++, y1++;
+
+            forward[i] = x1;
+
+            if (x1 > n)
+                forward_end += 2;
+            else if (y1 > m)
+                forward_start += 2;
+            else if (odd)
+            {
+                int j = offset + delta - k;
+
+                if (j >= 0 && j < size && backward[j] != -1 && x1 >= n - backward[j])
+                {
+                    x = a0 + x1;
+                    y = b0 + y1;
+                    return true;
+                }
+            }
+        }
+
+        for (int k = -d + backward_start; k <= d - backward_end; k += 2)
+        {
+            int i = offset + k;
+            int x2 = (k == -d || (k != d && backward[i - 1] < backward[i + 1])) ? backward[i + 1] : backward[i - 1] + 1;
+            int y2 = x2 - k;
+
+            while (x2 < n && y2 < m && a[a1 - x2 - 1] == b[b1 - y2 - 1])
+                x2++, y2++;
+
+            backward[i] = x2;
+
+            if (x2 > n)
+                backward_end += 2;
+            else if (y2 > m)
+                backward_start += 2;
+            else if (!odd)
+            {
+                int j = offset + delta - k;
+
+                if (j >= 0 && j < size && forward[j] != -1 && forward[j] >= n - x2)
+                {
+                    x = a0 + forward[j];
+                    y = b0 + forward[j] - (j - offset);
+                    return true;
+                }
+            }
+        }
+    }
+
+    // the paths can always meet within (n + m + 1) / 2
+    // edits, so if they didn't there's nothing in common.
+    if (max_d < max_cost)
+        return false;
+
+    // too expensive; split where the forward search got furthest.
+    int best = 0;
+
+    for (int i = 0; i < size; i++)
+    {
+        int x1 = forward[i], y1 = x1 - (i - offset);
+
+        if (x1 >= 0 && x1 <= n && y1 >= 0 && y1 <= m && x1 + y1 > best && x1 + y1 < n + m)
+        {
+            best = x1 + y1;
+            x = a0 + x1;
+            y = b0 + y1;
+        }
+    }
+
+    return best != 0;
+}
+
+uint32_t asIDBLineDiff::Map(uint32_t line, bool from_new) const
+{
+    auto from = [from_new](const Edit &e) { return from_new ? e.new_line : e.old_line; };
+    auto to = [from_new](const Edit &e) { return from_new ? e.old_line : e.new_line; };
+    uint32_t limit = from_new ? old_lines : new_lines;
+
+    // last run that starts at or before the line
+    auto it = std::upper_bound(edits.begin(), edits.end(), line, [&from](uint32_t l, const Edit &e) { return l < from(e); });
+
+    if (it == edits.begin())
+        return std::min(line, limit ? limit - 1 : 0);
+
+    it--;
+
+    // unchanged lines map one to one; changed
+    // lines map to where the change is.
+    uint32_t mapped = to(*it);
+
+    if (it->op == Op::Equal)
+        mapped += std::min(line - from(*it), it->count);
+
+    return std::min(mapped, limit ? limit - 1 : 0);
+}
+
+/*virtual*/ void asIDBDebugger::CacheLines(asIScriptModule *module)
+{
+    // the old tables for this module are going away, and so
+    // are those of any module that has since been discarded
+    // (a hot reload usually builds into a new module); the
+    // functions they point to may not exist anymore.
+    std::unordered_set<asIScriptModule *> modules;
+    asIScriptEngine *engine = module->GetEngine();
+
+    for (asUINT n = 0; n < engine->GetModuleCount(); n++)
+        modules.insert(engine->GetModuleByIndex(n));
+
+    for (auto it = section_lines.begin(); it != section_lines.end(); )
+    {
+        if (it->second.module == module || !modules.count(it->second.module))
+            it = section_lines.erase(it);
+        else
+            it++;
+    }
+
+    // functions are nearly always in a single section, so
+    // keep the last table around to skip the interning.
+    const char *lastSection = nullptr;
+    asIDBSectionLines *lastLines = nullptr;
+
+    auto addFunction = [&](asIScriptFunction *func) {
+        if (!func || func->GetFuncType() != asFUNC_SCRIPT)
+            return;
+
+        for (asUINT i = 0; i < func->GetLineEntryCount(); i++)
+        {
+            int row;
+            const char *section = nullptr;
+            func->GetLineEntry(i, &row, nullptr, &section, nullptr);
+
+            if (!section)
+                continue;
+            
+            if (section != lastSection)
+            {
+                lastSection = section;
+                lastLines = &section_lines[InternSection(section)];
+
+                // a rebuilt module is usually a new module, so the
+                // section's old table can belong to any module.
+                if (lastLines->module != module)
+                {
+                    *lastLines = asIDBSectionLines {};
+                    lastLines->module = module;
+                }
+            }
+
+            lastLines->lines.push_back({ row, func });
+        }
+    };
+
+    for (asUINT n = 0; n < module->GetFunctionCount(); n++)
+        addFunction(module->GetFunctionByIndex(n));
+
+    for (asUINT t = 0; t < module->GetObjectTypeCount(); t++)
+    {
+        auto type = module->GetObjectTypeByIndex(t);
+
+        for (asUINT n = 0; n < type->GetMethodCount(); n++)
+            addFunction(type->GetMethodByIndex(n, false));
+
+        for (asUINT n = 0; n < type->GetBehaviourCount(); n++)
+            addFunction(type->GetBehaviourByIndex(n, nullptr));
+
+        for (asUINT n = 0; n < type->GetFactoryCount(); n++)
+            addFunction(type->GetFactoryByIndex(n));
+    }
+
+    for (auto &[section, lines] : section_lines)
+    {
+        if (lines.module != module)
+            continue;
+
+        std::sort(lines.lines.begin(), lines.lines.end());
+        lines.lines.erase(std::unique(lines.lines.begin(), lines.lines.end()), lines.lines.end());
+
+        // rebuilt along with the lines, so nothing in
+        // here outlives the module it came from.
+        lines.functions.clear();
+
+        for (auto &entry : lines.lines)
+            lines.functions.push_back(entry.function);
+
+        std::sort(lines.functions.begin(), lines.functions.end());
+        lines.functions.erase(std::unique(lines.functions.begin(), lines.functions.end()), lines.functions.end());
+    }
+}
+
+const asIDBLineFunction *asIDBSectionLines::FindNearest(int line) const
+{
+    auto it = std::lower_bound(lines.begin(), lines.end(), line, [](const asIDBLineFunction &entry, int line) {
+        return entry.line < line;
+    });
+
+    return it == lines.end() ? nullptr : &*it;
+}
+
+asIScriptFunction *asIDBSectionLines::FindFunction(int line) const
+{
+    auto entry = FindNearest(line);
+
+    return (entry && entry->line == line) ? entry->function : nullptr;
+}
+
+/*virtual*/ void asIDBDebugger::CacheSymbols(asIScriptModule *module)
+{
+    for (auto it = section_symbols.begin(); it != section_symbols.end(); )
+    {
+        if (it->second.module == module)
+            it = section_symbols.erase(it);
+        else
+            it++;
+    }
+
+    // adds a function's declaration, spanning up to the last
+    // line it has code on. returns the symbol's section, or
+    // null if the function has no position.
+    auto addFunction = [&](asIScriptFunction *func, asIDBSymbolKind kind, int depth) -> asIDBSectionSymbols * {
+        if (!func || func->GetFuncType() != asFUNC_SCRIPT)
+            return nullptr;
+
+        const char *section = nullptr;
+        int row = 0;
+
+        if (func->GetDeclaredAt(&section, &row, nullptr) < 0 || !section || row <= 0)
+            return nullptr;
+
+        int end = row;
+
+        for (asUINT i = 0; i < func->GetLineEntryCount(); i++)
+        {
+            int line;
+            const char *line_section = nullptr;
+            func->GetLineEntry(i, &line, nullptr, &line_section, nullptr);
+
+            if (line_section && !strcmp(line_section, section))
+                end = std::max(end, line);
+        }
+
+        auto &symbols = section_symbols[InternSection(section)];
+
+        // same as CacheLines; the old declarations
+        // can belong to any module.
+        if (symbols.module != module)
+        {
+            symbols = asIDBSectionSymbols {};
+            symbols.module = module;
+        }
+
+        symbols.symbols.push_back({ kind, depth, row, end, func->GetName(), func->GetDeclaration(true, true, false) });
+        return &symbols;
+    };
+
+    for (asUINT n = 0; n < module->GetFunctionCount(); n++)
+        addFunction(module->GetFunctionByIndex(n), asIDBSymbolKind::Function, 0);
+
+    // AS doesn't keep a position for types, so they
+    // span the members that were declared with them.
+    for (asUINT t = 0; t < module->GetObjectTypeCount(); t++)
+    {
+        auto type = module->GetObjectTypeByIndex(t);
+        asIDBSectionSymbols *symbols = nullptr;
+        int line = std::numeric_limits<int>::max(), end = 0;
+
+        auto addMember = [&](asIScriptFunction *func) {
+            if (auto added = addFunction(func, asIDBSymbolKind::Method, 1))
+            {
+                if (!symbols)
+                    symbols = added;
+
+                // members in other sections stay with their section
+                if (added != symbols)
+                {
+                    added->symbols.back().depth = 0;
+                    return;
+                }
+
+                line = std::min(line, added->symbols.back().line);
+                end = std::max(end, added->symbols.back().end_line);
+            }
+        };
+
+        for (asUINT n = 0; n < type->GetMethodCount(); n++)
+            addMember(type->GetMethodByIndex(n, false));
+
+        for (asUINT n = 0; n < type->GetBehaviourCount(); n++)
+        {
+            asEBehaviours behaviour;
+            auto func = type->GetBehaviourByIndex(n, &behaviour);
+
+            if (behaviour == asBEHAVE_CONSTRUCT || behaviour == asBEHAVE_DESTRUCT)
+                addMember(func);
+        }
+
+        if (symbols)
+            symbols->symbols.push_back({ asIDBSymbolKind::Type, 0, line, end, type->GetName(), fmt::format("class {}", type->GetName()) });
+    }
+
+    // types sort in front of their first member
+    for (auto &[section, symbols] : section_symbols)
+    {
+        if (symbols.module != module)
+            continue;
+
+        std::sort(symbols.symbols.begin(), symbols.symbols.end(), [](const asIDBSymbol &a, const asIDBSymbol &b) {
+            return a.line < b.line || (a.line == b.line && a.depth < b.depth);
+        });
+    }
+
+    // the name table covers every module, so it's
+    // rebuilt from scratch.
+    symbol_names.clear();
+
+    for (auto &[section, symbols] : section_symbols)
+        for (uint32_t i = 0; i < symbols.symbols.size(); i++)
+            symbol_names[symbols.symbols[i].name].push_back({ section, i });
+}
+
+/*virtual*/ void asIDBDebugger::CacheEngineSymbols(asIScriptEngine *engine)
+{
+    std::array<asUINT, 6> counts {
+        engine->GetObjectTypeCount(),
+        engine->GetFuncdefCount(),
+        engine->GetEnumCount(),
+        engine->GetTypedefCount(),
+        engine->GetGlobalFunctionCount(),
+        engine->GetGlobalPropertyCount()
+    };
+
+    if (engine_symbols.generation && counts == engine_symbols.counts)
+        return;
+
+    auto &symbols = engine_symbols;
+    symbols.types.clear();
+    symbols.functions.clear();
+    symbols.values.clear();
+
+    for (asUINT i = 0; i < counts[0]; i++)
+        symbols.types.push_back(engine->GetObjectTypeByIndex(i)->GetName());
+
+    for (asUINT i = 0; i < counts[1]; i++)
+        symbols.types.push_back(engine->GetFuncdefByIndex(i)->GetName());
+
+    for (asUINT i = 0; i < counts[2]; i++)
+    {
+        auto type = engine->GetEnumByIndex(i);
+        symbols.types.push_back(type->GetName());
+
+        for (asUINT e = 0; e < type->GetEnumValueCount(); e++)
+            symbols.values.push_back(type->GetEnumValueByIndex(e, nullptr));
+    }
+
+    for (asUINT i = 0; i < counts[3]; i++)
+        symbols.types.push_back(engine->GetTypedefByIndex(i)->GetName());
+
+    for (asUINT i = 0; i < counts[4]; i++)
+        symbols.functions.push_back(engine->GetGlobalFunctionByIndex(i)->GetName());
+
+    for (asUINT i = 0; i < counts[5]; i++)
+    {
+        const char *name = nullptr;
+
+        if (engine->GetGlobalPropertyByIndex(i, &name) >= 0 && name)
+            symbols.values.push_back(name);
+    }
+
+    symbols.counts = counts;
+    symbols.generation++;
+}
+
+const asIDBSymbol *asIDBSectionSymbols::FindEnclosing(int line) const
+{
+    auto it = std::upper_bound(symbols.begin(), symbols.end(), line, [](int line, const asIDBSymbol &symbol) {
+        return line < symbol.line;
+    });
+
+    // walk back until a top-level declaration, since
+    // nothing before that can contain the line.
+    while (it != symbols.begin())
+    {
+        --it;
+
+        if (it->end_line >= line)
+            return &*it;
+        else if (it->depth == 0)
+            break;
+    }
+
+    return nullptr;
+}
+
+// header placed in front of every allocation, so that
+// frees can be attributed to the site they came from.
+// this is 16 bytes to retain malloc's alignment.
+struct asIDBAllocHeader
+{
+    struct asIDBAllocTableEntry *entry;
+    size_t                      size;
+};
+
+static_assert(sizeof(asIDBAllocHeader) == 16 || sizeof(void *) != 8, "alloc header must retain alignment");
+
+struct asIDBAllocTableEntry
+{
+    // (function ID + 1) << 32 | line; zero if unused.
+    // only the owning thread writes this.
+    std::atomic_uint64_t    key = 0;
+    std::atomic_int64_t     count = 0, bytes = 0;
+    std::atomic_int64_t     liveCount = 0, liveBytes = 0;
+};
+
+// fixed size open-addressed table of sites for a single thread.
+// tables are never freed, since allocations still point into
+// them; when a thread exits, its table is handed to the next
+// thread that needs one.
+struct asIDBAllocTable
+{
+    static constexpr size_t sizeBits = 12;
+    static constexpr size_t size = size_t(1) << sizeBits;
+    asIDBAllocTableEntry    entries[size];
+    std::atomic_bool        owned = true;
+
+    asIDBAllocTableEntry *Find(uint64_t key)
+    {
+        // std::hash is usually the identity, which would leave
+        // only the line number in the low bits; mix it first.
+        size_t h = size_t((key * 0x9E3779B97F4A7C15ull) >> (64 - sizeBits));
+
+        for (size_t i = 0; i < size; i++)
+        {
+            auto &entry = entries[(h + i) & (size - 1)];
+            uint64_t k = entry.key.load(std::memory_order_acquire);
+
+            if (k == key)
+                return &entry;
+            else if (!k)
+            {
+                entry.key.store(key, std::memory_order_release);
+                return &entry;
+            }
+        }
+
+        // full; this site won't be tracked.
+        return nullptr;
+    }
+};
+
+static constexpr size_t asIDBMaxAllocTables = 64;
+static std::atomic<asIDBAllocTable *> asIDBAllocTables[asIDBMaxAllocTables];
+static std::atomic_size_t asIDBNumAllocTables = 0;
+static std::atomic_bool asIDBAllocEnabled = false;
+static asALLOCFUNC_t asIDBAllocFunc = malloc;
+static asFREEFUNC_t asIDBFreeFunc = free;
+
+// the calling thread's table; released when the thread exits.
+struct asIDBAllocTableOwner
+{
+    asIDBAllocTable *table = nullptr;
+    bool            tableFull = false;
+
+    asIDBAllocTable *Acquire()
+    {
+        if (table || tableFull)
+            return table;
+
+        // take over a table left behind by a thread that exited
+        size_t numTables = std::min(asIDBNumAllocTables.load(), asIDBMaxAllocTables);
+
+        for (size_t i = 0; i < numTables; i++)
+        {
+            auto existing = asIDBAllocTables[i].load(std::memory_order_acquire);
+            bool owned = false;
+
+            if (existing && existing->owned.compare_exchange_strong(owned, true, std::memory_order_acq_rel))
+                return table = existing;
+        }
+
+        // note: plain new, not the AS memory functions.
+        if (size_t index = asIDBNumAllocTables++; index < asIDBMaxAllocTables)
+        {
+            table = new asIDBAllocTable;
+            asIDBAllocTables[index].store(table, std::memory_order_release);
+        }
+        else
+            tableFull = true;
+
+        return table;
+    }
+
+    ~asIDBAllocTableOwner()
+    {
+        if (table)
+            table->owned.store(false, std::memory_order_release);
+
+        // anything this thread allocates from here on isn't tracked.
+        table = nullptr;
+        tableFull = true;
+    }
+};
+
+/*static*/ void asIDBAllocProfiler::Install(asALLOCFUNC_t allocFunc, asFREEFUNC_t freeFunc)
+{
+    asIDBAllocFunc = allocFunc;
+    asIDBFreeFunc = freeFunc;
+    asSetGlobalMemoryFunctions(Alloc, Free);
+}
+
+/*static*/ void asIDBAllocProfiler::SetEnabled(bool enabled)
+{
+    asIDBAllocEnabled = enabled;
+}
+
+/*static*/ bool asIDBAllocProfiler::IsEnabled()
+{
+    return asIDBAllocEnabled;
+}
+
+/*static*/ void *asIDBAllocProfiler::Alloc(size_t size)
+{
+    auto header = reinterpret_cast<asIDBAllocHeader *>(asIDBAllocFunc(size + sizeof(asIDBAllocHeader)));
+
+    if (!header)
+        return nullptr;
+
+    header->entry = nullptr;
+    header->size = size;
+
+    if (asIDBAllocEnabled.load(std::memory_order_relaxed))
+    {
+        static thread_local asIDBAllocTableOwner owner;
+
+        if (auto table = owner.Acquire())
+        {
+            if (auto ctx = asGetActiveContext())
+            {
+                if (auto func = ctx->GetFunction(0))
+                {
+                    int line = ctx->GetLineNumber(0);
+                    uint64_t key = (uint64_t(func->GetId()) + 1) << 32 | uint32_t(line);
+
+                    if (auto entry = table->Find(key))
+                    {
+                        entry->count.fetch_add(1, std::memory_order_relaxed);
+                        entry->bytes.fetch_add(size, std::memory_order_relaxed);
+                        entry->liveCount.fetch_add(1, std::memory_order_relaxed);
+                        entry->liveBytes.fetch_add(size, std::memory_order_relaxed);
+                        header->entry = entry;
+                    }
+                }
+            }
+        }
+    }
+
+    return header + 1;
+}
+
+/*static*/ void asIDBAllocProfiler::Free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    auto header = reinterpret_cast<asIDBAllocHeader *>(ptr) - 1;
+
+    // entries are never freed, so this is safe even if
+    // the profiler has since been disabled.
+    if (auto entry = header->entry)
+    {
+        entry->liveCount.fetch_sub(1, std::memory_order_relaxed);
+        entry->liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    }
+
+    asIDBFreeFunc(header);
+}
+
+/*static*/ asIDBAllocSiteVector asIDBAllocProfiler::Collect()
+{
+    std::unordered_map<uint64_t, asIDBAllocSite> merged;
+    size_t numTables = std::min(asIDBNumAllocTables.load(), asIDBMaxAllocTables);
+
+    for (size_t t = 0; t < numTables; t++)
+    {
+        auto table = asIDBAllocTables[t].load(std::memory_order_acquire);
+
+        // still being set up by its thread
+        if (!table)
+            continue;
+
+        for (auto &entry : table->entries)
+        {
+            uint64_t key = entry.key.load(std::memory_order_acquire);
+
+            if (!key)
+                continue;
+
+            auto &site = merged.try_emplace(key, asIDBAllocSite { int(key >> 32) - 1, int(uint32_t(key)), 0, 0, 0, 0 }).first->second;
+            site.count += entry.count.load(std::memory_order_relaxed);
+            site.bytes += entry.bytes.load(std::memory_order_relaxed);
+            site.liveCount += entry.liveCount.load(std::memory_order_relaxed);
+            site.liveBytes += entry.liveBytes.load(std::memory_order_relaxed);
+        }
+    }
+
+    asIDBAllocSiteVector sites;
+    sites.reserve(merged.size());
+
+    for (auto &[key, site] : merged)
+        sites.push_back(site);
+
+    return sites;
+}
+
+int asIDBGCMonitor::GarbageCollect(asDWORD flags, asUINT numIterations)
+{
+    asIDBGCStage stage;
+
+    if (flags & asGC_FULL_CYCLE)
+        stage = asIDBGCStage::FullCycle;
+    else if ((flags & (asGC_DESTROY_GARBAGE | asGC_DETECT_GARBAGE)) == asGC_DESTROY_GARBAGE)
+        stage = asIDBGCStage::DestroyGarbage;
+    else if ((flags & (asGC_DESTROY_GARBAGE | asGC_DETECT_GARBAGE)) == asGC_DETECT_GARBAGE)
+        stage = asIDBGCStage::DetectGarbage;
+    else
+        stage = asIDBGCStage::OneStep;
+
+    asUINT destroyedBefore, detectedBefore;
+    engine->GetGCStatistics(nullptr, &destroyedBefore, &detectedBefore);
+
+    auto start = std::chrono::steady_clock::now();
+    int r = engine->GarbageCollect(flags, numIterations);
+    auto end = std::chrono::steady_clock::now();
+
+    asUINT destroyedAfter, detectedAfter;
+    engine->GetGCStatistics(nullptr, &destroyedAfter, &detectedAfter);
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    size_t bucket = 0;
+
+    for (auto v = us >> 1; v && bucket < asIDBGCStageStats::num_buckets - 1; v >>= 1)
+        bucket++;
+
+    std::scoped_lock lock(mutex);
+    auto &stats = stages[(size_t) stage];
+
+    stats.calls++;
+    stats.destroyed += destroyedAfter - destroyedBefore;
+    stats.detected += detectedAfter - detectedBefore;
+    stats.total_ms += ms;
+    stats.max_ms = std::max(stats.max_ms, ms);
+    stats.histogram[bucket]++;
+    pending_pause_ms += ms;
+
+    return r;
+}
+
+void asIDBGCMonitor::Poll()
+{
+    asUINT currentSize, totalDestroyed, totalDetected, newObjects;
+    engine->GetGCStatistics(&currentSize, &totalDestroyed, &totalDetected, &newObjects);
+
+    std::scoped_lock lock(mutex);
+
+    current_size = currentSize;
+    total_destroyed = totalDestroyed;
+    total_detected = totalDetected;
+
+    pause_history[history_offset] = (float) pending_pause_ms;
+    size_history[history_offset] = (float) currentSize;
+    // newObjects drops when the GC moves objects
+    // to the old generation, so only count growth.
+    new_history[history_offset] = (float) (newObjects > last_new_objects ? newObjects - last_new_objects : 0);
+    history_offset = (history_offset + 1) % history_size;
+
+    pending_pause_ms = 0;
+    last_new_objects = newObjects;
+}
+
+void asIDBGCMonitor::Reset()
+{
+    std::scoped_lock lock(mutex);
+
+    stages = {};
+    pause_history = {};
+    size_history = {};
+    new_history = {};
+    history_offset = 0;
+    pending_pause_ms = 0;
+}
+
+/*static*/ const char *asIDBGCMonitor::GetStageName(asIDBGCStage stage)
 {
-    sections.insert({ section, canonical });
+    static constexpr const char *names[] = {
+        "Full Cycle",
+        "One Step",
+        "Destroy Garbage",
+        "Detect Garbage"
+    };
+
+    return names[(size_t) stage];
 }
\ No newline at end of file
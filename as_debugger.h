@@ -21,11 +21,16 @@
 #include <unordered_set>
 #include <type_traits>
 #include <string>
-#include <map>
+#include <vector>
+#include <atomic>
 #include <fmt/format.h>
 #include <variant>
 #include <optional>
+#include <tuple>
+#include <array>
 #include <mutex>
+#include <cstdlib>
+#include <cassert>
 #include "angelscript.h"
 
 template <class T>
@@ -164,6 +169,8 @@ struct asIDBVarValue
 {
     bool disabled = false; // render with a different style
     asIDBExpandType expandable = asIDBExpandType::None;
+    bool truncated = false; // value is a preview; the full value can be
+                            // fetched with asIDBTypeEvaluator::FetchFullValue
     std::string value; // value to display in a value column or when expanded
 
     inline asIDBVarValue(const char *v, bool disabled = false, asIDBExpandType expandable = asIDBExpandType::None) :
@@ -273,6 +280,10 @@ public:
     // for expandable objects, this is called when the
     // debugger requests it be expanded.
     virtual void Expand(asIDBCache &, const asIDBResolvedVarAddr &id, asIDBVarState &state) const { }
+
+    // for truncated values, this is called when the
+    // debugger requests the complete value.
+    virtual std::string FetchFullValue(asIDBCache &, const asIDBResolvedVarAddr &) const { return {}; }
 };
 
 // built-in evaluators you can extend for
@@ -305,6 +316,112 @@ protected:
     void QueryVariableForEach(asIDBCache &cache, const asIDBResolvedVarAddr &id, asIDBVarState &var, int index = -1) const;
 };
 
+// evaluator for the engine's registered string type (the one
+// returned by GetStringFactory). only a short preview is kept;
+// the rest is fetched on demand. the string is copied out
+// through the string factory, since that's all AS knows about
+// it; override GetStringView to read your string type in-place.
+class asIDBStringTypeEvaluator : public asIDBTypeEvaluator
+{
+public:
+    // number of characters kept in the preview.
+    static constexpr size_t previewLength = 64;
+
+    virtual asIDBVarValue Evaluate(asIDBCache &cache, const asIDBResolvedVarAddr &id) const override;
+    virtual std::string FetchFullValue(asIDBCache &cache, const asIDBResolvedVarAddr &id) const override;
+
+protected:
+    // return a view of the string's contents. if this isn't
+    // possible, return false; `storage` can be used to hold
+    // a copy that the view refers to.
+    virtual bool GetStringView(asIDBCache &cache, const asIDBResolvedVarAddr &id, std::string_view &view, std::string &storage) const;
+};
+
+// string evaluator that reads the string in-place as an
+// std::string, without copying it. only register this for
+// types that really are std::string (like the one from
+// the scriptstdstring add-on):
+//   evaluators.Register<asIDBStdStringTypeEvaluator>(engine, "string");
+class asIDBStdStringTypeEvaluator : public asIDBStringTypeEvaluator
+{
+protected:
+    virtual bool GetStringView(asIDBCache &, const asIDBResolvedVarAddr &id, std::string_view &view, std::string &) const override
+    {
+        view = *reinterpret_cast<const std::string *>(id.resolved);
+        return true;
+    }
+};
+
+// maps C++ primitive types to their AngelScript type ID;
+// zero for anything else.
+template<typename T> struct asIDBPrimitiveTypeId { static constexpr int value = 0; };
+template<> struct asIDBPrimitiveTypeId<bool> { static constexpr int value = asTYPEID_BOOL; };
+template<> struct asIDBPrimitiveTypeId<int8_t> { static constexpr int value = asTYPEID_INT8; };
+template<> struct asIDBPrimitiveTypeId<int16_t> { static constexpr int value = asTYPEID_INT16; };
+template<> struct asIDBPrimitiveTypeId<int32_t> { static constexpr int value = asTYPEID_INT32; };
+template<> struct asIDBPrimitiveTypeId<int64_t> { static constexpr int value = asTYPEID_INT64; };
+template<> struct asIDBPrimitiveTypeId<uint8_t> { static constexpr int value = asTYPEID_UINT8; };
+template<> struct asIDBPrimitiveTypeId<uint16_t> { static constexpr int value = asTYPEID_UINT16; };
+template<> struct asIDBPrimitiveTypeId<uint32_t> { static constexpr int value = asTYPEID_UINT32; };
+template<> struct asIDBPrimitiveTypeId<uint64_t> { static constexpr int value = asTYPEID_UINT64; };
+template<> struct asIDBPrimitiveTypeId<float> { static constexpr int value = asTYPEID_FLOAT; };
+template<> struct asIDBPrimitiveTypeId<double> { static constexpr int value = asTYPEID_DOUBLE; };
+
+// a single member of a native (C++) type, for use
+// with asIDBNativeTypeEvaluator. primitive members are
+// read & formatted directly; other members need the
+// declaration of their registered type.
+template<typename T, typename F>
+struct asIDBNativeField
+{
+    const char  *name;
+    F T::*      member;
+    const char  *typeDecl = nullptr;
+};
+
+template<typename T, typename F, std::enable_if_t<asIDBPrimitiveTypeId<F>::value != 0, int> = 0>
+constexpr asIDBNativeField<T, F> asIDBField(const char *name, F T::*member)
+{
+    return { name, member, nullptr };
+}
+
+// non-primitive members must be given their type's
+// declaration, so there's no overload without it.
+template<typename T, typename F>
+constexpr asIDBNativeField<T, F> asIDBField(const char *name, F T::*member, const char *typeDecl)
+{
+    return { name, member, typeDecl };
+}
+
+// an evaluator for registered C++ types generated from a
+// list of fields; for example:
+//   evaluators.RegisterNative<vec3_t>(engine, "vec3_t",
+//       asIDBField("x", &vec3_t::x), asIDBField("y", &vec3_t::y), asIDBField("z", &vec3_t::z));
+// Evaluate reads the members directly, and Expand never
+// has to query the engine for properties.
+template<typename T, typename... F>
+class asIDBNativeTypeEvaluator : public asIDBTypeEvaluator
+{
+public:
+    asIDBNativeTypeEvaluator(asIScriptEngine *engine, asIDBNativeField<T, F>... fields) :
+        fields(fields...),
+        typeIds { (asIDBPrimitiveTypeId<F>::value ? asIDBPrimitiveTypeId<F>::value :
+                   fields.typeDecl ? engine->GetTypeIdByDecl(fields.typeDecl) : 0)... }
+    {
+        // every field has to resolve to a type, otherwise
+        // Evaluate would list fields that Expand can't show.
+        for (int typeId : typeIds)
+            assert(typeId > 0 && "asIDBField type declaration missing or not registered");
+    }
+
+    virtual asIDBVarValue Evaluate(asIDBCache &cache, const asIDBResolvedVarAddr &id) const override;
+    virtual void Expand(asIDBCache &cache, const asIDBResolvedVarAddr &id, asIDBVarState &state) const override;
+
+protected:
+    std::tuple<asIDBNativeField<T, F>...>   fields;
+    std::array<int, sizeof...(F)>           typeIds;
+};
+
 // This class manages `asIDBTypeEvaluator` instances
 // and handles the logic of finding the best
 // instance for the given type.
@@ -331,6 +448,9 @@ public:
     // debugger requests it be expanded.
     void Expand(class asIDBCache &, const asIDBResolvedVarAddr &id, asIDBVarState &state) const;
 
+    // for truncated values, fetch the complete value.
+    std::string FetchFullValue(class asIDBCache &, const asIDBResolvedVarAddr &id) const;
+
     // Register an evaluator.
     void Register(int typeId, std::unique_ptr<asIDBTypeEvaluator> evaluator);
 
@@ -341,6 +461,14 @@ public:
     {
         Register(engine->GetTypeInfoByName(name)->GetTypeId(), std::make_unique<T>());
     }
+
+    // Register an asIDBNativeTypeEvaluator for the native
+    // type T with the given fields.
+    template<typename T, typename... F>
+    void RegisterNative(asIScriptEngine *engine, const char *name, asIDBNativeField<T, F>... fields)
+    {
+        Register(engine->GetTypeInfoByName(name)->GetTypeId(), std::make_unique<asIDBNativeTypeEvaluator<T, F...>>(engine, fields...));
+    }
 };
 
 // the result of an expression evaluation.
@@ -353,12 +481,39 @@ struct asIDBExprResult
     asIDBVarState   value;
 };
 
+// where an expression's root variable came from.
+enum class asIDBExprRoot : uint8_t
+{
+    None,   // not recorded; always re-resolve
+    Local,  // local/parameter, by variable index
+    This,   // `this`
+    Member, // property of `this`
+    Global  // global, by index
+};
+
+// what an expression was resolved through. if the root
+// and every pointer read along the way are unchanged, the
+// expression resolves to the same address as last time.
+struct asIDBExprDeps
+{
+    asIDBExprRoot       root = asIDBExprRoot::None;
+    int                 index = 0;          // variable or global index
+    void                *root_address = nullptr;
+    int                 stack_index = -1;
+    asIScriptFunction   *function = nullptr; // function at stack_index
+    std::vector<bool>   scope;              // locals in scope at the time
+
+    // pointers that were dereferenced, in order, and their values.
+    std::vector<std::pair<void *, void *>> reads;
+};
+
 // watch entry name + result.
 // set to dirty if the value is out of date.
 struct asIDBWatchEntry : public asIDBVarViewBase
 {
     bool                               dirty = true;
     std::optional<asIDBExprResult>     result;
+    asIDBExprDeps                      deps;
 
     inline asIDBWatchEntry(const char *expr) :
         asIDBVarViewBase(expr, "")
@@ -417,6 +572,10 @@ public:
     // ptr back to debugger
     class asIDBDebugger *dbg;
 
+    // if set, ResolveExpression records what it
+    // resolves through into here.
+    asIDBExprDeps *expr_deps = nullptr;
+
     inline asIDBCache(class asIDBDebugger *dbg, asIScriptContext *ctx) :
         dbg(dbg),
         ctx(ctx)
@@ -492,8 +651,88 @@ public:
     // Resolve the remainder of a sub-expression; see ResolveExpression
     // for the syntax.
     virtual std::optional<asIDBExprResult> ResolveSubExpression(const asIDBResolvedVarAddr &idKey, const std::string_view rest, int stack_index);
+
+    // bring a watch entry up to date. if nothing it was
+    // resolved through has changed, only its value is
+    // re-evaluated; otherwise the expression is resolved again.
+    virtual void RefreshWatch(asIDBWatchEntry &entry, int stack_index);
+
+    // check if the expression deps still hold.
+    virtual bool ExprDepsValid(const asIDBExprDeps &deps, int stack_index);
+
+protected:
+    // record a pointer read into expr_deps, if set.
+    inline void RecordExprRead(void *address)
+    {
+        if (expr_deps)
+            expr_deps->reads.emplace_back(address, *reinterpret_cast<void **>(address));
+    }
+
+    inline void RecordExprRoot(asIDBExprRoot root, int index, void *address)
+    {
+        if (expr_deps)
+        {
+            expr_deps->root = root;
+            expr_deps->index = index;
+            expr_deps->root_address = address;
+        }
+    }
 };
 
+template<typename T, typename... F>
+/*virtual*/ asIDBVarValue asIDBNativeTypeEvaluator<T, F...>::Evaluate(asIDBCache &cache, const asIDBResolvedVarAddr &id) const /*override*/
+{
+    const T *obj = reinterpret_cast<const T *>(id.resolved);
+    fmt::memory_buffer buf;
+
+    std::apply([&](auto &...field) {
+        const char *sep = "";
+
+        ((fmt::format_to(std::back_inserter(buf), "{}{}: ", sep, field.name),
+          sep = ", ",
+          [&](auto &value) {
+              if constexpr (asIDBPrimitiveTypeId<std::decay_t<decltype(value)>>::value != 0)
+                  fmt::format_to(std::back_inserter(buf), "{}", value);
+              else
+                  fmt::format_to(std::back_inserter(buf), "{{...}}");
+          }(obj->*field.member)), ...);
+    }, fields);
+
+    return { fmt::to_string(buf), false, sizeof...(F) ? asIDBExpandType::Children : asIDBExpandType::None };
+}
+
+template<typename T, typename... F>
+/*virtual*/ void asIDBNativeTypeEvaluator<T, F...>::Expand(asIDBCache &cache, const asIDBResolvedVarAddr &id, asIDBVarState &state) const /*override*/
+{
+    T *obj = reinterpret_cast<T *>(id.resolved);
+    size_t i = 0;
+
+    std::apply([&](auto &...field) {
+        ([&](auto &field, int typeId) {
+            // we don't know what this is, so we can't show it.
+            if (!typeId)
+                return;
+
+            asIDBVarAddr fieldId { typeId, id.source.constant, &(obj->*field.member) };
+
+            bool exists;
+            auto it = cache.AddVarState(fieldId, exists);
+
+            if (!exists)
+            {
+                using FieldType = std::decay_t<decltype(obj->*field.member)>;
+
+                if constexpr (asIDBPrimitiveTypeId<FieldType>::value != 0)
+                    it->second.value = { fmt::format("{}", obj->*field.member), false };
+                else
+                    it->second.value = cache.evaluators.Evaluate(cache, fieldId);
+            }
+
+            state.children.push_back(asIDBVarView { field.name, cache.GetTypeNameFromType({ typeId, id.source.constant ? asTM_CONST : asTM_NONE }), it });
+        }(field, typeIds[i++]), ...);
+    }, fields);
+}
+
 struct asIDBBreakpointLocation
 {
     std::string_view    section;
@@ -516,6 +755,14 @@ struct std::hash<asIDBBreakpointLocation>
     }
 };
 
+// binding state of a file location breakpoint.
+enum class asIDBBindState : uint8_t
+{
+    Pending,   // section has no line table yet; breaks on the exact line
+    Bound,     // resolved to a line that has code
+    Unbound    // section is known, but no code exists at or after the line
+};
+
 struct asIDBBreakpoint
 {
 private:
@@ -524,6 +771,12 @@ private:
 public:
     std::variant<asIDBBreakpointLocation, std::string>  location;
 
+    // for file location breakpoints, the result of the
+    // last call to asIDBDebugger::BindBreakpoints. these
+    // don't participate in hashing/equality.
+    mutable asIDBBindState  bind_state = asIDBBindState::Pending;
+    mutable int             bound_line = 0;
+
     static asIDBBreakpoint Function(std::string_view f)
     {
         asIDBBreakpoint bp;
@@ -566,8 +819,280 @@ enum class asIDBAction : uint8_t
     StepOut
 };
 
-// map of script source path -> canonical name.
-using asIDBSectionSet = std::map<std::string_view, std::string_view>;
+// what a step filter pattern is matched against.
+enum class asIDBStepFilterType : uint8_t
+{
+    Section,   // the script section the function is in
+    Namespace, // the namespace the function is in
+    Function   // the qualified name of the function (ns::Type::Name)
+};
+
+// a "Just My Code" filter; functions that match any
+// filter are stepped through instead of broken on.
+// patterns are globs (`*` and `?`).
+struct asIDBStepFilter
+{
+    asIDBStepFilterType type;
+    std::string         pattern;
+};
+
+using asIDBStepFilterVector = std::vector<asIDBStepFilter>;
+
+// flat map of script source path -> canonical name,
+// kept sorted by path.
+class asIDBSectionSet
+{
+public:
+    using value_type = std::pair<std::string_view, std::string_view>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    // find the entry for the given path.
+    const_iterator find(std::string_view section) const;
+
+    // insert a path, if it isn't already present.
+    // returns true if it was inserted.
+    bool insert(const value_type &entry);
+
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+private:
+    std::vector<value_type> entries;
+};
+
+// fuzzy matcher for quick-open style searches. entries
+// are added once; a search skips every entry that doesn't
+// have all of the query's characters (using a bitmask per
+// entry), then scores the rest by subsequence matching.
+class asIDBFuzzyIndex
+{
+public:
+    struct Result
+    {
+        uint32_t    index;
+        int         score;
+    };
+
+    void Clear();
+
+    // add an entry; returns its index.
+    uint32_t Add(std::string_view text);
+
+    size_t Size() const { return entries.size(); }
+    std::string_view Get(uint32_t index) const { return { text.data() + entries[index].offset, entries[index].length }; }
+
+    // find the (up to) k best entries for the query,
+    // best first. matching is case insensitive.
+    void Search(std::string_view query, size_t k, std::vector<Result> &results) const;
+
+    // score text against a lowercased query, with lower being
+    // the lowercased text. returns -1 if there's no match.
+    static int Score(std::string_view text, std::string_view lower, std::string_view query);
+
+    // bitmask of the characters in the given text.
+    static uint64_t Mask(std::string_view text);
+
+private:
+    struct Entry
+    {
+        uint32_t    offset, length;
+        uint64_t    mask;
+    };
+
+    // text of every entry, packed together.
+    std::string         text, lower;
+    std::vector<Entry>  entries;
+};
+
+// line diff between two versions of a source. lines are
+// interned to integers up front, so the search itself only
+// compares integers; the search is Myers' linear space
+// variant, with a cap on how far it looks before settling
+// for a good enough split on very different inputs.
+class asIDBLineDiff
+{
+public:
+    enum class Op : uint8_t
+    {
+        Equal,
+        Delete, // only in the old text
+        Insert  // only in the new text
+    };
+
+    // a run of lines; lines are zero-based.
+    struct Edit
+    {
+        Op          op;
+        uint32_t    old_line, new_line, count;
+    };
+
+    std::vector<Edit>   edits;
+    uint32_t            old_lines = 0, new_lines = 0;
+    uint32_t            removed = 0, added = 0;
+
+    // diff the two texts; lines are split on newlines,
+    // so an empty text is a single empty line.
+    void Compute(std::string_view old_text, std::string_view new_text);
+
+    // find the line in the other text that is the
+    // closest match for the given line.
+    uint32_t MapToNew(uint32_t old_line) const { return Map(old_line, false); }
+    uint32_t MapToOld(uint32_t new_line) const { return Map(new_line, true); }
+
+private:
+    // interned lines that both texts have, and
+    // where they are in their text.
+    std::vector<uint32_t>   a, b;
+    std::vector<uint32_t>   index_a, index_b;
+
+    // lines that aren't in the common subsequence.
+    std::vector<uint8_t>    changed_a, changed_b;
+
+    // furthest reaching paths, per diagonal.
+    std::vector<int>        forward, backward;
+
+    // find where to split the given ranges; returns
+    // false if they have nothing in common.
+    bool Split(int a0, int a1, int b0, int b1, int &x, int &y);
+
+    uint32_t Map(uint32_t line, bool from_new) const;
+};
+
+// a line within a section that has bytecode, and the
+// function that the bytecode belongs to.
+struct asIDBLineFunction
+{
+    int                 line;
+    asIScriptFunction   *function;
+
+    constexpr bool operator<(const asIDBLineFunction &other) const
+    {
+        return line < other.line || (line == other.line && function < other.function);
+    }
+
+    constexpr bool operator==(const asIDBLineFunction &other) const
+    {
+        return line == other.line && function == other.function;
+    }
+};
+
+// sorted table of the lines with code in a single section.
+struct asIDBSectionLines
+{
+    // module the functions belong to.
+    asIScriptModule                 *module = nullptr;
+    std::vector<asIDBLineFunction>  lines;
+
+    // unique functions that have code in this section.
+    std::vector<asIScriptFunction *> functions;
+
+    // find the first line with code that is at or
+    // after the given line, or null if there is none.
+    const asIDBLineFunction *FindNearest(int line) const;
+
+    // find the function with code on exactly the given
+    // line, or null if the line has no code.
+    asIScriptFunction *FindFunction(int line) const;
+};
+
+// map of section -> lines with code; keys are interned.
+using asIDBSectionLineMap = std::unordered_map<std::string_view, asIDBSectionLines>;
+
+enum class asIDBSymbolKind : uint8_t
+{
+    Function,
+    Method,
+    Type
+};
+
+// a declaration found through the engine's metadata.
+struct asIDBSymbol
+{
+    asIDBSymbolKind kind;
+    int             depth;    // 1 for members of a type
+    int             line;     // one-based
+    int             end_line; // last line with code; inclusive
+    std::string     name;     // unqualified
+    std::string     declaration;
+};
+
+// declarations in a single section, ordered by line.
+struct asIDBSectionSymbols
+{
+    // module the declarations belong to.
+    asIScriptModule             *module = nullptr;
+    std::vector<asIDBSymbol>    symbols;
+
+    // find the innermost declaration that spans
+    // the given line, or null if there is none.
+    const asIDBSymbol *FindEnclosing(int line) const;
+};
+
+// map of section -> declarations; keys are interned.
+using asIDBSectionSymbolMap = std::unordered_map<std::string_view, asIDBSectionSymbols>;
+
+// where to find a declaration in asIDBSectionSymbolMap.
+struct asIDBSymbolRef
+{
+    std::string_view section;
+    uint32_t         index;
+};
+
+// names the application registered with the engine,
+// so frontends can highlight them.
+struct asIDBEngineSymbols
+{
+    std::vector<std::string> types;     // object types, funcdefs, enums and typedefs
+    std::vector<std::string> functions; // global functions
+    std::vector<std::string> values;    // global properties and enum values
+
+    // how much of each kind the engine had registered when
+    // these were built. AS doesn't say when registrations
+    // change, so the counts are compared instead.
+    std::array<asUINT, 6> counts {};
+
+    // bumped whenever these are rebuilt.
+    uint32_t generation = 0;
+};
+
+// exact call stats for a single function, in nanoseconds.
+struct asIDBFunctionProfile
+{
+    std::string name; // declaration; empty if never called
+    uint64_t    calls = 0;
+    int64_t     inclusive = 0, exclusive = 0;
+    uint32_t    active = 0; // recursion depth; inclusive time only
+                            // counts the outermost activation.
+};
+
+// a function on the profiler's shadow call stack.
+struct asIDBProfileFrame
+{
+    int     functionId;
+    int64_t enter;
+    int64_t children; // inclusive time of callees
+};
+
+// state for instrumentation profiling; see StartProfiling.
+struct asIDBCallProfile
+{
+    // guards everything below; the line callback and the
+    // UI touch this from different threads.
+    std::mutex mutex;
+
+    // indexed by function ID.
+    std::vector<asIDBFunctionProfile> functions;
+
+    // mirror of the context's call stack.
+    std::vector<asIDBProfileFrame>  stack;
+    asIScriptContext                *ctx = nullptr;
+
+    int64_t start = 0;      // when profiling began
+    int64_t last = 0;       // time of the last line callback
+    int64_t paused = 0;     // time spent in the profiler or suspended; not counted
+    int64_t overhead = 0;   // calibrated cost of a clock read
+    int64_t elapsed = 0;    // total time profiled, once stopped
+};
 
 // This is the main class for interfacing with
 // the debugger. This manages the debugger thread
@@ -587,21 +1112,67 @@ public:
     // (used to prevent infinite loops)
     std::atomic_bool internal_execution = false;
 
+    // step filters; use SetStepFilters to change these.
+    asIDBStepFilterVector step_filters;
+
+    // step filter results, indexed by function ID.
+    // 0 = not checked yet, 1 = user code, 2 = skipped.
+    std::vector<uint8_t> step_skip;
+
     // mutex for shared state, like the cache and breakpoints.
     std::recursive_mutex mutex;
     
     // active breakpoints
     std::unordered_set<asIDBBreakpoint> breakpoints;
 
+    // locations that file breakpoints are currently
+    // bound to; this is what the line callback checks.
+    std::unordered_set<asIDBBreakpointLocation> bound_breakpoints;
+
+    // functions that function breakpoints are currently
+    // bound to. if no line tables are available, function
+    // breakpoints stay pending and are matched by name.
+    std::unordered_set<asIScriptFunction *> bound_functions;
+    bool pending_function_breakpoints = false;
+
+    // owned storage for section names, so that views into
+    // them stay valid even if a module is discarded.
+    std::unordered_set<std::string> section_names;
+
     // cached sections
     asIDBSectionSet sections;
 
+    // bumped whenever a module is built, so frontends can
+    // tell when sources they kept around might be stale.
+    uint32_t module_generation = 0;
+
+    // lines with code, per section. rebuilt when
+    // a module is built.
+    asIDBSectionLineMap section_lines;
+
+    // declarations, per section and by unqualified
+    // name. rebuilt when a module is built.
+    asIDBSectionSymbolMap section_symbols;
+    std::unordered_map<std::string, std::vector<asIDBSymbolRef>> symbol_names;
+
+    // registered names; see CacheEngineSymbols.
+    asIDBEngineSymbols engine_symbols;
+
     // cache for the current active broken state.
     // the cache is only kept for the duration of
     // a broken state; resuming in any way destroys
     // the cache.
     std::unique_ptr<asIDBCache> cache;
 
+    // instrumentation profiling; use StartProfiling
+    // and StopProfiling to change these.
+    std::atomic_bool profiling = false;
+    asIDBCallProfile profile;
+
+    // optional GC monitor to show in the UI; not owned
+    // by the debugger, since it has to outlive it.
+    class asIDBGCMonitor *gc_monitor = nullptr;
+
     asIDBDebugger() { }
     virtual ~asIDBDebugger() { }
 
@@ -633,8 +1204,53 @@ public:
     void StepOut();
     void Continue();
 
-    // breakpoint stuff
+    // breakpoint stuff. if the section's lines are known,
+    // the line is snapped to the nearest line with code.
     bool ToggleBreakpoint(std::string_view section, int line);
+    void RemoveBreakpoint(const asIDBBreakpoint &bp);
+
+    // resolve every file location breakpoint to the nearest
+    // line with code, and every function breakpoint to the
+    // functions with that name, using the cached line tables.
+    void BindBreakpoints();
+
+    // call this whenever a module is built (or rebuilt, for
+    // hot reloading); this caches the module's sections and
+    // lines with code, then rebinds breakpoints.
+    void ModuleBuilt(asIScriptModule *module);
+
+    // returns a view into an owned copy of the section name.
+    std::string_view InternSection(std::string_view section);
+
+    // returns which of the variables of the function at the
+    // given stack level are in scope. scope depends on the exact
+    // program position (a single line can open and close scopes)
+    // which AS doesn't expose, so this asks the context each time.
+    std::vector<bool> GetVarsInScope(asIScriptContext *ctx, asUINT stackLevel);
+
+    // replace the step filters.
+    void SetStepFilters(asIDBStepFilterVector filters);
+
+    // start an exact profile of every script call. Function
+    // entry and exit are inferred from the call stack depth in
+    // the line callback, so contexts have to be hooked for the
+    // duration (HasWork returns true while profiling). The cost
+    // of the profiler itself is measured and subtracted out.
+    void StartProfiling();
+    void StopProfiling();
+
+    // check if stepping should skip over the given function.
+    // the filters are only matched once per function.
+    inline bool IsStepFiltered(asIScriptFunction *func)
+    {
+        if (step_filters.empty() || !func)
+            return false;
+
+        if (size_t id = func->GetId(); id < step_skip.size() && step_skip[id])
+            return step_skip[id] == 2;
+
+        return MatchStepFilters(func);
+    }
     
     // add script sections; note that this must be done entirely
     // by an overridden class, and you'll have to keep track of
@@ -644,9 +1260,26 @@ public:
     // the sections it can find with functions.
     virtual void CacheSections(asIScriptModule *module);
 
+    // scans every module in the engine for sections. this is
+    // the same as calling CacheSections on each of them, but
+    // the scan is spread across worker threads.
+    virtual void CacheAllSections(asIScriptEngine *engine);
+
     // adds to cache.
     virtual void EnsureSectionCached(std::string_view section, std::string_view canonical);
 
+    // builds the line tables for every section that
+    // the given module has code in.
+    virtual void CacheLines(asIScriptModule *module);
+
+    // builds the declaration tables for the
+    // functions and types of the given module.
+    virtual void CacheSymbols(asIScriptModule *module);
+
+    // rebuilds engine_symbols if the engine's
+    // registrations have changed since.
+    virtual void CacheEngineSymbols(asIScriptEngine *engine);
+
     // get the source code for the given section
     // of the given module.
     virtual std::string FetchSource(const char *section) = 0;
@@ -663,5 +1296,126 @@ protected:
     // create a cache for the given context.
     virtual std::unique_ptr<asIDBCache> CreateCache(asIScriptContext *ctx) = 0;
 
+    // match the function against the step filters,
+    // and store the result in step_skip.
+    bool MatchStepFilters(asIScriptFunction *func);
+
+    // update the shadow call stack from the line callback.
+    void ProfileLine(asIScriptContext *ctx);
+
+    // push/pop shadow call stack frames; the profile
+    // mutex must be held.
+    void PushProfileFrame(asIScriptFunction *func, int64_t now);
+    void PopProfileFrame(int64_t now);
+
     static void LineCallback(asIScriptContext *ctx, asIDBDebugger *debugger);
 };
+
+// a call site that script memory was allocated from.
+struct asIDBAllocSite
+{
+    int     functionId; // function ID; may no longer exist
+    int     line;
+    int64_t count, bytes;           // total allocations
+    int64_t liveCount, liveBytes;   // allocations not yet freed
+};
+
+using asIDBAllocSiteVector = std::vector<asIDBAllocSite>;
+
+// Allocation profiler for script memory. This replaces the
+// global AngelScript memory functions with ones that attribute
+// every allocation to the script function + line that is active
+// on the allocating thread. Because memory has to be freed by
+// the same functions that allocated it, Install must be called
+// before any engine is created. Tracking is only done while the
+// profiler is enabled; each thread records into its own table,
+// so there are no locks on the allocation path.
+class asIDBAllocProfiler
+{
+public:
+    // install the memory functions; the given functions
+    // are used for the actual memory.
+    static void Install(asALLOCFUNC_t allocFunc = malloc, asFREEFUNC_t freeFunc = free);
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    // merge every thread's table into a list of sites.
+    static asIDBAllocSiteVector Collect();
+
+private:
+    static void *Alloc(size_t size);
+    static void Free(void *ptr);
+};
+
+// the kind of work a GarbageCollect call was asked to do.
+enum class asIDBGCStage
+{
+    FullCycle,
+    OneStep,
+    DestroyGarbage,
+    DetectGarbage,
+
+    Count
+};
+
+// pause time + object stats for one GC stage.
+struct asIDBGCStageStats
+{
+    // bucket N holds pauses of [2^N, 2^(N+1)) microseconds;
+    // the first and last buckets also hold everything below/above.
+    static constexpr size_t num_buckets = 24;
+
+    uint64_t calls = 0;
+    uint64_t destroyed = 0, detected = 0;
+    double total_ms = 0, max_ms = 0;
+    std::array<uint32_t, num_buckets> histogram {};
+};
+
+// Monitors the garbage collector of an engine. Call GarbageCollect
+// on this instead of the engine so that the pauses can be timed,
+// and Poll once per frame (or on a timer) to sample the GC size.
+// All storage is fixed-size, so it never allocates after construction.
+// Assign it to asIDBDebugger::gc_monitor to show it in the UI.
+class asIDBGCMonitor
+{
+public:
+    static constexpr size_t history_size = 256;
+
+    asIScriptEngine *engine;
+
+    // lock when reading the stats below from another thread.
+    std::mutex mutex;
+
+    std::array<asIDBGCStageStats, (size_t) asIDBGCStage::Count> stages {};
+
+    // rolling history, one entry per Poll. `history_offset`
+    // is the index of the oldest entry.
+    std::array<float, history_size> pause_history {};  // ms spent collecting since the previous Poll
+    std::array<float, history_size> size_history {};   // objects in the GC
+    std::array<float, history_size> new_history {};    // objects added since the previous Poll
+    size_t history_offset = 0;
+
+    // latest values from GetGCStatistics.
+    asUINT current_size = 0, total_destroyed = 0, total_detected = 0;
+
+    asIDBGCMonitor(asIScriptEngine *engine) :
+        engine(engine)
+    {
+    }
+
+    // time a GarbageCollect call on the engine and record it.
+    int GarbageCollect(asDWORD flags = asGC_FULL_CYCLE, asUINT numIterations = 1);
+
+    // sample the GC statistics into the history.
+    void Poll();
+
+    // clear all of the stats and history.
+    void Reset();
+
+    static const char *GetStageName(asIDBGCStage stage);
+
+private:
+    double pending_pause_ms = 0;
+    asUINT last_new_objects = 0;
+};
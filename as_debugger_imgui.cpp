@@ -25,8 +25,18 @@ void asIDBImGuiFrontend::SetupImGui()
     // add default font as fallback for ui
     io.Fonts->AddFontDefault();
 
+    if (debugger->cache)
+        ChangeScript();
+}
+
+void asIDBImGuiFrontend::SetupEditor(TextEditor &editor)
+{
     editor.SetReadOnlyEnabled(true);
+    editor.SetLargeFileThreshold(4 * 1024 * 1024);
     editor.SetLanguage(TextEditor::Language::AngelScript());
+    editor.SetIdentifiers(&engineIdentifiers);
+    editor.SetFoldingEnabled(true);
+    editor.SetShowMinimapEnabled(true);
     editor.SetLineDecorator(17.f, [this](TextEditor::Decorator &decorator) {
         auto size = decorator.height - 1.0f;
         auto pos = ImGui::GetCursorScreenPos();
@@ -39,10 +49,18 @@ void asIDBImGuiFrontend::SetupImGui()
 
         if (auto it = debugger->breakpoints.find(bp); it != debugger->breakpoints.end())
         {
-            drawlist->AddCircleFilled(
-                ImVec2(pos.x - 1 + size * 0.5, pos.y + size * 0.5f),
-                (size - 6.0f) * 0.5f,
-                IM_COL32(255, 0, 0, 255));
+            // unbound breakpoints will never be hit,
+            // so they're drawn hollow.
+            if (it->bind_state == asIDBBindState::Unbound)
+                drawlist->AddCircle(
+                    ImVec2(pos.x - 1 + size * 0.5, pos.y + size * 0.5f),
+                    (size - 6.0f) * 0.5f,
+                    IM_COL32(255, 0, 0, 255), 0, 1.5f);
+            else
+                drawlist->AddCircleFilled(
+                    ImVec2(pos.x - 1 + size * 0.5, pos.y + size * 0.5f),
+                    (size - 6.0f) * 0.5f,
+                    IM_COL32(255, 0, 0, 255));
         }
 
         if (decorator.line == update_row - 1)
@@ -61,18 +79,227 @@ void asIDBImGuiFrontend::SetupImGui()
                 ImDrawFlags_RoundCornersAll, 1.5);
         }
     });
-    // TODO: text callback for watch/breakpoints
+    editor.SetLineAnnotator([this](int line) { return GetInlineValues(line); });
+    editor.SetTextContextMenuCallback([this, &editor](int line, int column) {
+        if (ImGui::MenuItem("Go to Definition", "F12"))
+            definitionExpr = editor.GetExpressionAt(line, column);
+
+        auto tab = std::find_if(sourceTabs.begin(), sourceTabs.end(), [&editor](const asIDBSourceTab &t) { return t.editor.get() == &editor; });
+
+        if (ImGui::MenuItem("Compare with Previous Version", nullptr, false, tab != sourceTabs.end() && !tab->previous.empty()))
+            OpenDiff(tab->section);
+
+        ImGui::Separator();
+
+        if (ImGui::MenuItem("Word Wrap", nullptr, editor.IsWordWrapEnabled()))
+            editor.SetWordWrapEnabled(!editor.IsWordWrapEnabled());
+        if (ImGui::MenuItem("Minimap", nullptr, editor.IsShowMinimapEnabled()))
+            editor.SetShowMinimapEnabled(!editor.IsShowMinimapEnabled());
+    });
 
-    if (debugger->cache)
-        ChangeScript();
+}
+
+void asIDBImGuiFrontend::OpenSourceTab(std::string_view section)
+{
+    section = debugger->InternSection(section);
+
+    auto tab = std::find_if(sourceTabs.begin(), sourceTabs.end(), [section](const asIDBSourceTab &t) { return t.section == section; });
+
+    if (tab == sourceTabs.end())
+    {
+        tab = sourceTabs.emplace(sourceTabs.end());
+        tab->section = section;
+        tab->editor = std::make_unique<TextEditor>();
+        tab->generation = debugger->module_generation - 1;
+        SetupEditor(*tab->editor);
+    }
+
+    // reload if a module was built since
+    if (tab->generation != debugger->module_generation)
+    {
+        auto file = debugger->FetchSource(section.data());
+
+        // hold on to what the engine had before, so hot reloads
+        // can be diffed against it. the editor drops carriage
+        // returns and BOMs, so the raw sources are compared.
+        size_t hash = std::hash<std::string_view>()(file);
+
+        if (tab->source_hash && tab->source_hash != hash)
+            tab->previous = tab->editor->GetText();
+
+        tab->source_hash = hash;
+        tab->editor->SetText(file);
+        tab->size = file.size() + tab->previous.size();
+        tab->generation = debugger->module_generation;
+    }
+
+    tab->last_used = ++sourceTabClock;
+    editor = tab->editor.get();
+    selected_stack_section = section;
+    selectSourceTab = true;
+
+    // close least recently used tabs if we're over the limit;
+    // the selected one is always the most recently used.
+    size_t total = 0;
+
+    for (auto &t : sourceTabs)
+        total += t.size;
+
+    while (total > sourceTabMemoryLimit && sourceTabs.size() > 1)
+    {
+        auto lru = std::min_element(sourceTabs.begin(), sourceTabs.end(), [](const asIDBSourceTab &a, const asIDBSourceTab &b) { return a.last_used < b.last_used; });
+        total -= lru->size;
+        sourceTabs.erase(lru);
+    }
+}
+
+void asIDBImGuiFrontend::CloseSourceTab(std::string_view section)
+{
+    auto tab = std::find_if(sourceTabs.begin(), sourceTabs.end(), [section](const asIDBSourceTab &t) { return t.section == section; });
+
+    if (tab == sourceTabs.end())
+        return;
+
+    bool selected = tab->editor.get() == editor;
+    sourceTabs.erase(tab);
+
+    if (!selected)
+        return;
+
+    // switch to the most recently used tab that's left
+    editor = nullptr;
+    selected_stack_section = {};
+
+    auto mru = std::max_element(sourceTabs.begin(), sourceTabs.end(), [](const asIDBSourceTab &a, const asIDBSourceTab &b) { return a.last_used < b.last_used; });
+
+    if (mru != sourceTabs.end())
+        OpenSourceTab(mru->section);
+
+    resetOpenStates = true;
+}
+
+void asIDBImGuiFrontend::GoToLine(std::string_view section, int line)
+{
+    OpenSourceTab(section);
+
+    if (editor && line > 0)
+    {
+        editor->SetCursor(line - 1, 0);
+        editor->ScrollToLine(line - 1, TextEditor::Scroll::alignMiddle);
+    }
+
+    resetOpenStates = true;
+}
+
+void asIDBImGuiFrontend::OpenDiff(std::string_view section)
+{
+    auto tab = std::find_if(sourceTabs.begin(), sourceTabs.end(), [section](const asIDBSourceTab &t) { return t.section == section; });
+
+    if (tab == sourceTabs.end() || tab->previous.empty())
+        return;
+
+    auto current = tab->editor->GetText();
+    diff.Compute(tab->previous, current);
+
+    for (auto *side : { &diffOld, &diffNew })
+    {
+        side->SetReadOnlyEnabled(true);
+        side->SetLargeFileThreshold(4 * 1024 * 1024);
+        side->SetLanguage(TextEditor::Language::AngelScript());
+        side->SetIdentifiers(&engineIdentifiers);
+        side->SetShowMinimapEnabled(true);
+    }
+
+    diffOld.SetText(tab->previous);
+    diffNew.SetText(current);
+
+    // removed lines on the left, added lines on the right
+    for (auto &edit : diff.edits)
+    {
+        if (edit.op == asIDBLineDiff::Op::Delete)
+            for (uint32_t i = 0; i < edit.count; i++)
+                diffOld.AddMarker(edit.old_line + i, IM_COL32(255, 96, 96, 255), IM_COL32(255, 0, 0, 48), "", "");
+        else if (edit.op == asIDBLineDiff::Op::Insert)
+            for (uint32_t i = 0; i < edit.count; i++)
+                diffNew.AddMarker(edit.new_line + i, IM_COL32(96, 255, 96, 255), IM_COL32(0, 255, 0, 48), "", "");
+    }
+
+    // start at the first change; the other side follows
+    auto first = std::find_if(diff.edits.begin(), diff.edits.end(), [](const asIDBLineDiff::Edit &e) { return e.op != asIDBLineDiff::Op::Equal; });
+
+    if (first != diff.edits.end())
+        diffNew.ScrollToLine(std::max((int) first->new_line - 3, 0), TextEditor::Scroll::alignTop);
+
+    diffSection = tab->section;
+    diffFollower = nullptr;
+    diffOldFirstLine = diffNewFirstLine = -1;
+    showDiff = true;
+    ImGui::SetWindowFocus("Changes");
+}
+
+void asIDBImGuiFrontend::RenderDiff()
+{
+    if (!showDiff)
+        return;
+
+    if (ImGui::Begin("Changes", &showDiff))
+    {
+        auto section = debugger->sections.find(diffSection);
+        std::string_view name = section != debugger->sections.end() ? section->second : diffSection;
+        ImGui::TextDisabled("%.*s: %u lines removed, %u added", (int) name.size(), name.data(), diff.removed, diff.added);
+
+        if (ImGui::BeginTable("##Diff", 2, ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersInnerV))
+        {
+            ImGui::TableNextColumn();
+            diffOld.Render("Previous", ImVec2(-1, -1));
+            ImGui::TableNextColumn();
+            diffNew.Render("Current", ImVec2(-1, -1));
+            ImGui::EndTable();
+        }
+
+        // keep both sides lined up; whichever one was scrolled
+        // leads, and the other gets a frame to catch up before
+        // its own scrolling counts.
+        int oldFirst = diffOld.GetFirstVisibleLine();
+        int newFirst = diffNew.GetFirstVisibleLine();
+
+        if (diffFollower == &diffOld)
+            diffOldFirstLine = oldFirst;
+        else if (diffFollower == &diffNew)
+            diffNewFirstLine = newFirst;
+
+        diffFollower = nullptr;
+
+        if (newFirst != diffNewFirstLine)
+        {
+            diffOld.ScrollToLine((int) diff.MapToOld(newFirst), TextEditor::Scroll::alignTop);
+            diffFollower = &diffOld;
+        }
+        else if (oldFirst != diffOldFirstLine)
+        {
+            diffNew.ScrollToLine((int) diff.MapToNew(oldFirst), TextEditor::Scroll::alignTop);
+            diffFollower = &diffNew;
+        }
+
+        diffOldFirstLine = oldFirst;
+        diffNewFirstLine = newFirst;
+    }
+    ImGui::End();
 }
 
 // script changed, so clear stuff that
 // depends on the old script.
 void asIDBImGuiFrontend::ChangeScript()
 {
-    editor.ClearCursors();
-    editor.ClearMarkers();
+    if (editor)
+        editor->ClearCursors();
+
+    // the current line marker may be in any tab
+    for (auto &tab : sourceTabs)
+        if (tab.editor->HasMarkers())
+            tab.editor->ClearMarkers();
+
+    inlineValuesCache = nullptr;
 
     asIScriptContext *ctx = debugger->cache->ctx;
     
@@ -98,19 +325,336 @@ void asIDBImGuiFrontend::ChangeScript()
     if (!func)
         return;
 
-    if (selected_stack_section != sec)
+    OpenSourceTab(sec);
+
+    editor->SetCursor(update_row - 1, 0);
+    editor->ScrollToLine(update_row - 1, TextEditor::Scroll::alignMiddle);
+    editor->AddMarker(update_row - 1, 0, IM_COL32(127, 127, 0, 127), "", "");
+
+    resetOpenStates = true;
+}
+
+std::string_view asIDBImGuiFrontend::GetInlineValues(int line)
+{
+    asIDBCache *cache = debugger->cache.get();
+
+    if (!cache)
+        return {};
+
+    // frame changed; find the locals that are in scope,
+    // and the lines of the function that have run so far.
+    if (inlineValuesCache != cache || inlineValuesStackEntry != selected_stack_entry)
     {
-        selected_stack_section = sec;
+        inlineValuesCache = cache;
+        inlineValuesStackEntry = selected_stack_entry;
+        inlineValuesSection = {};
+        inlineValuesFirstLine = 0;
+        inlineValuesLastLine = -1;
+        inlineLocals.clear();
+        inlineValues.clear();
+
+        asIScriptContext *ctx = cache->ctx;
+        asIScriptFunction *func = ctx->GetFunction(selected_stack_entry);
+        const char *section = nullptr;
+        int row = func ? ctx->GetLineNumber(selected_stack_entry, nullptr, &section) : 0;
+
+        if (!section)
+            return {};
+
+        int declRow = 0;
+        func->GetDeclaredAt(nullptr, &declRow, nullptr);
+
+        inlineValuesSection = debugger->InternSection(section);
+        inlineValuesFirstLine = declRow - 1;
+        inlineValuesLastLine = row - 1;
 
-        auto file = debugger->FetchSource(sec);
-        editor.SetText(file);
+        auto inScope = debugger->GetVarsInScope(ctx, selected_stack_entry);
+
+        // later variables shadow earlier ones
+        for (int n = 0; n < ctx->GetVarCount(selected_stack_entry); n++)
+        {
+            const char *name;
+            ctx->GetVar(n, selected_stack_entry, &name);
+
+            if (!name || !*name || ((size_t) n < inScope.size() && !inScope[n]))
+                continue;
+
+            inlineLocals[name] = { n, std::nullopt };
+        }
     }
 
-    editor.SetCursor(update_row - 1, 0);
-    editor.ScrollToLine(update_row - 1, TextEditor::Scroll::alignMiddle);
-    editor.AddMarker(update_row - 1, 0, IM_COL32(127, 127, 0, 127), "", "");
+    if (line < inlineValuesFirstLine || line > inlineValuesLastLine || selected_stack_section != inlineValuesSection)
+        return {};
 
-    resetOpenStates = true;
+    if (auto f = inlineValues.find(line); f != inlineValues.end())
+        return f->second;
+
+    auto &text = inlineValues[line];
+
+    editor->GetLineIdentifiers(line, inlineIdentifiers);
+
+    for (size_t i = 0; i < inlineIdentifiers.size(); i++)
+    {
+        auto &id = inlineIdentifiers[i];
+        auto local = inlineLocals.find(id);
+
+        if (local == inlineLocals.end())
+            continue;
+        // only show each variable once per line
+        else if (std::find(inlineIdentifiers.begin(), inlineIdentifiers.begin() + i, id) != inlineIdentifiers.begin() + i)
+            continue;
+
+        if (!local->second.value)
+        {
+            asIScriptContext *ctx = cache->ctx;
+            int n = local->second.index;
+            int typeId;
+            asETypeModifiers modifiers;
+            ctx->GetVar(n, selected_stack_entry, nullptr, &typeId, &modifiers);
+
+            asIDBVarAddr idKey { typeId, (modifiers & asTM_CONST) != 0, ctx->GetAddressOfVar(n, selected_stack_entry) };
+            bool exists;
+            auto stateIt = cache->AddVarState(idKey, exists);
+
+            if (!exists)
+                stateIt->second.value = cache->evaluators.Evaluate(*cache, idKey);
+
+            std::string value = stateIt->second.value.value;
+
+            if (value.size() > 32)
+            {
+                value.resize(29);
+                value += "...";
+            }
+
+            local->second.value = std::move(value);
+        }
+
+        fmt::format_to(std::back_inserter(text), "{}{} = {}", text.empty() ? "" : ", ", id, *local->second.value);
+    }
+
+    return text;
+}
+
+void asIDBImGuiFrontend::RenderQuickOpen()
+{
+    constexpr size_t maxResults = 50;
+    bool search = false;
+
+    if (ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_P, false))
+    {
+        if (!quickOpenIndexed || quickOpenGeneration != debugger->module_generation)
+        {
+            quickOpenIndex.Clear();
+            quickOpenTargets.clear();
+
+            for (auto &section : debugger->sections)
+            {
+                quickOpenIndex.Add(section.second);
+                quickOpenTargets.push_back({ section.first, 0 });
+            }
+
+            for (auto &[section, lines] : debugger->section_lines)
+            {
+                for (auto func : lines.functions)
+                {
+                    int row = 0;
+
+                    if (func->GetDeclaredAt(nullptr, &row, nullptr) < 0 || row <= 0)
+                        continue;
+
+                    quickOpenIndex.Add(func->GetDeclaration(true, true, false));
+                    quickOpenTargets.push_back({ section, row });
+                }
+            }
+
+            quickOpenIndexed = true;
+            quickOpenGeneration = debugger->module_generation;
+        }
+
+        quickOpenQuery[0] = '\0';
+        quickOpenSelected = 0;
+        search = true;
+
+        ImGui::OpenPopup("Quick Open");
+        ImGui::SetNextWindowPos(ImVec2(viewport->GetCenter().x, viewport->WorkPos.y + viewport->WorkSize.y * 0.2f), ImGuiCond_Always, ImVec2(0.5f, 0.0f));
+        ImGui::SetNextWindowSize(ImVec2(viewport->WorkSize.x * 0.5f, 0));
+    }
+
+    if (!ImGui::BeginPopup("Quick Open"))
+        return;
+
+    if (ImGui::IsWindowAppearing())
+        ImGui::SetKeyboardFocusHere();
+
+    ImGui::SetNextItemWidth(-1);
+
+    if (ImGui::InputTextWithHint("##QuickOpen", "Section or function...", quickOpenQuery, sizeof(quickOpenQuery)))
+    {
+        quickOpenSelected = 0;
+        search = true;
+    }
+
+    if (search)
+        quickOpenIndex.Search(quickOpenQuery, maxResults, quickOpenResults);
+
+    int count = (int) quickOpenResults.size();
+    bool moved = false;
+
+    if (count)
+    {
+        if (ImGui::IsKeyPressed(ImGuiKey_DownArrow))
+            quickOpenSelected = (quickOpenSelected + 1) % count, moved = true;
+        else if (ImGui::IsKeyPressed(ImGuiKey_UpArrow))
+            quickOpenSelected = (quickOpenSelected + count - 1) % count, moved = true;
+    }
+
+    int chosen = -1;
+
+    if (count && (ImGui::IsKeyPressed(ImGuiKey_Enter) || ImGui::IsKeyPressed(ImGuiKey_KeypadEnter)))
+        chosen = quickOpenSelected;
+
+    for (int i = 0; i < count; i++)
+    {
+        auto &result = quickOpenResults[i];
+        auto &target = quickOpenTargets[result.index];
+        auto label = quickOpenIndex.Get(result.index);
+
+        ImGui::PushID(i);
+
+        if (ImGui::Selectable(std::string(label).c_str(), i == quickOpenSelected))
+            chosen = i;
+
+        if (i == quickOpenSelected && moved)
+            ImGui::SetScrollHereY();
+
+        // show where functions live
+        if (target.line)
+        {
+            auto name = debugger->sections.find(target.section);
+            std::string_view path = name != debugger->sections.end() ? name->second : target.section;
+            ImGui::SameLine();
+            ImGui::TextDisabled("%.*s:%i", (int) path.size(), path.data(), target.line);
+        }
+
+        ImGui::PopID();
+    }
+
+    if (ImGui::IsKeyPressed(ImGuiKey_Escape))
+        ImGui::CloseCurrentPopup();
+
+    if (chosen != -1)
+    {
+        auto &target = quickOpenTargets[quickOpenResults[chosen].index];
+        GoToLine(target.section, target.line);
+        ImGui::CloseCurrentPopup();
+    }
+
+    ImGui::EndPopup();
+}
+
+void asIDBImGuiFrontend::RenderGoToDefinition()
+{
+    if (!definitionExpr.empty())
+    {
+        // only the last name of a member/scope chain matters
+        std::string_view name = definitionExpr;
+
+        if (auto sep = name.find_last_of(".:"); sep != std::string_view::npos)
+            name.remove_prefix(sep + 1);
+
+        definitionCandidates.clear();
+
+        if (auto it = debugger->symbol_names.find(std::string(name)); it != debugger->symbol_names.end())
+            definitionCandidates = it->second;
+
+        definitionExpr.clear();
+
+        if (definitionCandidates.size() == 1)
+        {
+            auto &ref = definitionCandidates[0];
+            GoToLine(ref.section, debugger->section_symbols.at(ref.section).symbols[ref.index].line);
+        }
+        else if (definitionCandidates.size() > 1)
+            ImGui::OpenPopup("##Definitions");
+    }
+
+    if (!ImGui::BeginPopup("##Definitions"))
+        return;
+
+    for (auto &ref : definitionCandidates)
+    {
+        // a module may have been rebuilt since
+        auto symbols = debugger->section_symbols.find(ref.section);
+
+        if (symbols == debugger->section_symbols.end() || ref.index >= symbols->second.symbols.size())
+            continue;
+
+        auto &symbol = symbols->second.symbols[ref.index];
+        auto name = debugger->sections.find(ref.section);
+        std::string_view path = name != debugger->sections.end() ? name->second : ref.section;
+
+        ImGui::PushID(&symbol);
+
+        if (ImGui::Selectable(symbol.declaration.c_str()))
+            GoToLine(ref.section, symbol.line);
+
+        ImGui::SameLine();
+        ImGui::TextDisabled("%.*s:%i", (int) path.size(), path.data(), symbol.line);
+        ImGui::PopID();
+    }
+
+    ImGui::EndPopup();
+}
+
+void asIDBImGuiFrontend::RenderHoverEvaluation()
+{
+    asIDBCache *cache = debugger->cache.get();
+
+    if (hoverCache != cache || hoverStackEntry != selected_stack_entry)
+    {
+        hoverCache = cache;
+        hoverStackEntry = selected_stack_entry;
+        hoverResults.clear();
+    }
+
+    int line, column;
+
+    // the editor only reports a location once the mouse
+    // has rested on it for a bit, which debounces this.
+    if (!ImGui::IsPopupOpen("##HoverEvaluation") && editor->GetHoverLocation(line, column))
+    {
+        if (auto expr = editor->GetExpressionAt(line, column); !expr.empty())
+        {
+            hoverExpr = std::move(expr);
+            ImGui::OpenPopup("##HoverEvaluation");
+        }
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(400, 0));
+
+    if (!ImGui::BeginPopup("##HoverEvaluation"))
+        return;
+
+    auto [it, inserted] = hoverResults.try_emplace(hoverExpr, hoverExpr.c_str());
+    auto &entry = it->second;
+
+    if (entry.dirty)
+        cache->RefreshWatch(entry, selected_stack_entry);
+
+    if (entry.IsValid())
+        RenderVariableTable("##HoverEvaluation", [&]() { RenderDebuggerVariable(entry, nullptr); });
+    else
+        ImGui::TextDisabled("%s: can't evaluate", hoverExpr.c_str());
+
+    // close once the mouse wanders off
+    float margin = ImGui::GetTextLineHeight() * 2;
+    ImVec2 pos = ImGui::GetWindowPos(), size = ImGui::GetWindowSize();
+
+    if (!ImGui::IsMouseHoveringRect(ImVec2(pos.x - margin, pos.y - margin), ImVec2(pos.x + size.x + margin, pos.y + size.y + margin), false))
+        ImGui::CloseCurrentPopup();
+
+    ImGui::EndPopup();
 }
 
 // this is the loop for the thread.
@@ -143,6 +687,7 @@ bool asIDBImGuiFrontend::Render(bool full)
             ImGui::DockBuilderSplitNode(dockspace_id, ImGuiDir_Down, 0.20f, &dock_id_down, &dock_id_top);
             ImGui::DockBuilderDockWindow("Call Stack", dock_id_down);
             ImGui::DockBuilderDockWindow("Breakpoints", dock_id_down);
+            ImGui::DockBuilderDockWindow("Step Filters", dock_id_down);
             ImGui::DockBuilderDockWindow("Exception", dock_id_down);
 
             {
@@ -150,7 +695,9 @@ bool asIDBImGuiFrontend::Render(bool full)
                 ImGui::DockBuilderSplitNode(dock_id_top, ImGuiDir_Left, 0.20f, &dock_id_left, &dock_id_right);
                 
                 ImGui::DockBuilderDockWindow("Sections", dock_id_left);
+                ImGui::DockBuilderDockWindow("Outline", dock_id_left);
                 ImGui::DockBuilderDockWindow("Source", dock_id_right);
+                ImGui::DockBuilderDockWindow("Changes", dock_id_right);
             }
 
             {
@@ -161,6 +708,10 @@ bool asIDBImGuiFrontend::Render(bool full)
                 ImGui::DockBuilderDockWindow("Temporaries", dock_id_right);
                 ImGui::DockBuilderDockWindow("Globals", dock_id_right);
                 ImGui::DockBuilderDockWindow("Watch", dock_id_right);
+                ImGui::DockBuilderDockWindow("Value Viewer", dock_id_right);
+                ImGui::DockBuilderDockWindow("Allocations", dock_id_right);
+                ImGui::DockBuilderDockWindow("GC", dock_id_right);
+                ImGui::DockBuilderDockWindow("Profiler", dock_id_right);
             }
         }
 
@@ -187,6 +738,31 @@ bool asIDBImGuiFrontend::Render(bool full)
         auto *cache = this->debugger->cache.get();
 
         asIScriptContext *ctx = cache ? cache->ctx : nullptr;
+
+        if (ctx)
+            debugger->CacheEngineSymbols(ctx->GetEngine());
+
+        if (auto &symbols = debugger->engine_symbols; engineIdentifiersGeneration != symbols.generation)
+        {
+            engineIdentifiers.clear();
+
+            for (auto &name : symbols.types)
+                engineIdentifiers.insert(name, TextEditor::Color::declaration);
+            for (auto &name : symbols.functions)
+                engineIdentifiers.insert(name, TextEditor::Color::knownIdentifier);
+            for (auto &name : symbols.values)
+                engineIdentifiers.insert(name, TextEditor::Color::knownIdentifier);
+
+            engineIdentifiersGeneration = symbols.generation;
+
+            // recolor what's open
+            for (auto &tab : sourceTabs)
+                tab.editor->SetIdentifiers(&engineIdentifiers);
+
+            diffOld.SetIdentifiers(&engineIdentifiers);
+            diffNew.SetIdentifiers(&engineIdentifiers);
+        }
+
         bool isException = ctx ? (ctx->GetState() == asEXECUTION_EXCEPTION) : false;
 
         if (!full || isException)
@@ -210,10 +786,10 @@ bool asIDBImGuiFrontend::Render(bool full)
             {
                 debugger->StepOut();
             }
-            else if (ImGui::MenuItem("Toggle Breakpoint"))
+            else if (ImGui::MenuItem("Toggle Breakpoint") && editor)
             {
                 int line, col;
-                editor.GetMainCursor(line, col);
+                editor->GetMainCursor(line, col);
                 debugger->ToggleBreakpoint(selected_stack_section, line + 1);
             }
             ImGui::EndMainMenuBar();
@@ -260,30 +836,113 @@ bool asIDBImGuiFrontend::Render(bool full)
                 ImGui::TableHeadersRow();
 
                 int n = 0;
+                std::optional<asIDBBreakpoint> removeBreakpoint;
 
-                for (auto it = debugger->breakpoints.begin(); it != debugger->breakpoints.end(); )
+                for (auto &bp : debugger->breakpoints)
                 {
-                    auto &bp = *it;
                     ImGui::PushID(n++);
                     ImGui::TableNextRow();
                     ImGui::TableNextColumn();
                     if (bp.location.index() == 0)
                     {
                         auto &v = std::get<0>(bp.location);
-                        ImGui::Text(fmt::format("{} : {}", v.section, v.line).c_str());
+
+                        asIScriptFunction *func = nullptr;
+
+                        if (auto lines = debugger->section_lines.find(v.section); lines != debugger->section_lines.end())
+                            func = lines->second.FindFunction(bp.bound_line);
+
+                        if (bp.bind_state == asIDBBindState::Unbound)
+                            ImGui::TextDisabled("%s", fmt::format("{} : {} (no code)", v.section, v.line).c_str());
+                        else if (bp.bind_state == asIDBBindState::Bound && bp.bound_line != v.line)
+                            ImGui::Text(fmt::format("{} : {} (bound to {})", v.section, v.line, bp.bound_line).c_str());
+                        else
+                            ImGui::Text(fmt::format("{} : {}", v.section, v.line).c_str());
+
+                        if (func)
+                        {
+                            ImGui::SameLine();
+                            ImGui::TextDisabled("%s", func->GetName());
+                        }
                     }
+                    else if (bp.bind_state == asIDBBindState::Unbound)
+                        ImGui::TextDisabled("%s (not found)", std::get<1>(bp.location).c_str());
                     else
                         ImGui::Text(std::get<1>(bp.location).c_str());
                     ImGui::TableNextColumn();
                     if (ImGui::Button("X"))
-                        it = debugger->breakpoints.erase(it);
-                    else
-                        it++;
+                        removeBreakpoint = bp;
+                    ImGui::PopID();
+                }
+
+                ImGui::EndTable();
+
+                if (removeBreakpoint)
+                    debugger->RemoveBreakpoint(*removeBreakpoint);
+            }
+        }
+        ImGui::End();
+
+        if (ImGui::Begin("Step Filters", nullptr, ImGuiWindowFlags_HorizontalScrollbar))
+        {
+            static constexpr const char *filterTypeNames[] = { "Section", "Namespace", "Function" };
+            std::optional<size_t> removeFilter;
+
+            if (ImGui::BeginTable("##filters", 3,
+                ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH |
+                ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg |
+                ImGuiTableFlags_NoBordersInBody))
+            {
+                ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableSetupColumn("Pattern", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Delete", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableHeadersRow();
+
+                for (size_t n = 0; n < debugger->step_filters.size(); n++)
+                {
+                    auto &filter = debugger->step_filters[n];
+                    ImGui::PushID((int) n);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(filterTypeNames[(int) filter.type]);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(filter.pattern.c_str());
+                    ImGui::TableNextColumn();
+                    if (ImGui::Button("X"))
+                        removeFilter = n;
                     ImGui::PopID();
                 }
 
                 ImGui::EndTable();
             }
+
+            if (removeFilter)
+            {
+                auto filters = debugger->step_filters;
+                filters.erase(filters.begin() + *removeFilter);
+                debugger->SetStepFilters(std::move(filters));
+            }
+
+            static int filterType = 0;
+            static char filterBuf[256] {};
+
+            for (int i = 0; i < (int) std::size(filterTypeNames); i++)
+            {
+                ImGui::RadioButton(filterTypeNames[i], &filterType, i);
+                ImGui::SameLine();
+            }
+
+            ImGui::PushItemWidth(-1);
+            ImGui::InputTextWithHint("##AddFilter", "Pattern (* and ? wildcards)...", filterBuf, sizeof(filterBuf));
+            ImGui::PopItemWidth();
+
+            if (ImGui::IsItemDeactivatedAfterEdit() && *filterBuf)
+            {
+                auto filters = debugger->step_filters;
+                filters.push_back({ (asIDBStepFilterType) filterType, filterBuf });
+                debugger->SetStepFilters(std::move(filters));
+                filterBuf[0] = '\0';
+            }
         }
         ImGui::End();
 
@@ -365,6 +1024,32 @@ bool asIDBImGuiFrontend::Render(bool full)
         }
         ImGui::End();
 
+        if (ImGui::Begin("Allocations"))
+            RenderAllocations();
+        ImGui::End();
+
+        if (ImGui::Begin("Profiler"))
+            RenderProfiler();
+        ImGui::End();
+
+        if (debugger->gc_monitor)
+        {
+            if (ImGui::Begin("GC"))
+                RenderGCMonitor();
+            ImGui::End();
+        }
+
+        if (showValueViewer)
+        {
+            if (ImGui::Begin("Value Viewer", &showValueViewer, ImGuiWindowFlags_HorizontalScrollbar))
+            {
+                ImGui::TextDisabled("%s (%zu chars)", valueViewerName.c_str(), valueViewerText.size());
+                ImGui::Separator();
+                ImGui::TextUnformatted(valueViewerText.data(), valueViewerText.data() + valueViewerText.size());
+            }
+            ImGui::End();
+        }
+
         if (!full)
             ImGui::PopItemFlag();
 
@@ -379,9 +1064,102 @@ bool asIDBImGuiFrontend::Render(bool full)
             }
         }
         ImGui::End();
+
+        if (ImGui::Begin("Outline", nullptr, ImGuiWindowFlags_HorizontalScrollbar))
+        {
+            if (auto symbols = debugger->section_symbols.find(selected_stack_section); editor && symbols != debugger->section_symbols.end())
+            {
+                int line, column;
+                editor->GetMainCursor(line, column);
+                auto current = symbols->second.FindEnclosing(line + 1);
+
+                for (auto &symbol : symbols->second.symbols)
+                {
+                    ImGui::PushID(&symbol);
+
+                    if (symbol.depth)
+                        ImGui::Indent();
+
+                    if (ImGui::Selectable(symbol.declaration.c_str(), &symbol == current))
+                    {
+                        editor->SetCursor(symbol.line - 1, 0);
+                        editor->ScrollToLine(symbol.line - 1, TextEditor::Scroll::alignMiddle);
+                    }
+
+                    if (symbol.depth)
+                        ImGui::Unindent();
+
+                    ImGui::PopID();
+                }
+            }
+        }
+        ImGui::End();
         
         if (ImGui::Begin("Source"))
-            editor.Render("Source", ImVec2(-1, -1));
+        {
+            std::string_view close_section;
+
+            if (ImGui::BeginTabBar("##SourceTabs", ImGuiTabBarFlags_Reorderable | ImGuiTabBarFlags_FittingPolicyScroll))
+            {
+                for (auto &tab : sourceTabs)
+                {
+                    bool selected = tab.editor.get() == editor;
+                    bool open = true;
+                    auto name = debugger->sections.find(tab.section);
+                    std::string label = fmt::format("{}###{}", name != debugger->sections.end() ? name->second : tab.section, tab.section);
+
+                    ImGuiTabItemFlags flags = (selected && selectSourceTab) ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
+
+                    // reloaded with changes; see "Compare with Previous Version"
+                    if (!tab.previous.empty())
+                        flags |= ImGuiTabItemFlags_UnsavedDocument;
+
+                    if (ImGui::BeginTabItem(label.c_str(), &open, flags))
+                    {
+                        if (!selected)
+                        {
+                            // switched by the user (and not just waiting
+                            // for our own selection to take effect)
+                            if (!selectSourceTab)
+                                change_section = tab.section;
+                        }
+                        else
+                        {
+                            selectSourceTab = false;
+
+                            // show breakpoints in the minimap
+                            editor->ClearMinimapHighlights();
+
+                            for (auto &bp : debugger->breakpoints)
+                                if (auto loc = std::get_if<asIDBBreakpointLocation>(&bp.location); loc && loc->section == selected_stack_section)
+                                    editor->AddMinimapHighlight(loc->line - 1, IM_COL32(255, 0, 0, 255));
+
+                            editor->Render("Source", ImVec2(-1, -1));
+
+                            if (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) && ImGui::IsKeyPressed(ImGuiKey_F12, false))
+                            {
+                                int line, column;
+                                editor->GetMainCursor(line, column);
+                                definitionExpr = editor->GetExpressionAt(line, column);
+                            }
+
+                            if (cache)
+                                RenderHoverEvaluation();
+                        }
+
+                        ImGui::EndTabItem();
+                    }
+
+                    if (!open)
+                        close_section = tab.section;
+                }
+
+                ImGui::EndTabBar();
+            }
+
+            if (!close_section.empty())
+                CloseSourceTab(close_section);
+        }
         ImGui::End();
 
         if (isException)
@@ -402,7 +1180,8 @@ bool asIDBImGuiFrontend::Render(bool full)
 
                 if (ImGui::Button("OK", ImVec2(70, 20)))
                 {
-                    editor.ScrollToLine(update_row - 1, TextEditor::Scroll::alignMiddle);
+                    if (editor)
+                        editor->ScrollToLine(update_row - 1, TextEditor::Scroll::alignMiddle);
                     ImGui::CloseCurrentPopup();
                 }
 
@@ -410,15 +1189,15 @@ bool asIDBImGuiFrontend::Render(bool full)
             }
         }
 
+        RenderDiff();
+        RenderQuickOpen();
+        RenderGoToDefinition();
+
         if (!change_section.empty())
         {
             if (selected_stack_section != change_section)
             {
-                selected_stack_section = change_section;
-
-                auto file = debugger->FetchSource(selected_stack_section.data());
-                editor.SetText(file);
-
+                OpenSourceTab(change_section);
                 resetOpenStates = true;
             }
         }
@@ -451,10 +1230,10 @@ bool asIDBImGuiFrontend::Render(bool full)
         wasVisible = true;
     }
 
-    if (ImGui::IsKeyPressed(ImGuiKey::ImGuiKey_F9, false))
+    if (ImGui::IsKeyPressed(ImGuiKey::ImGuiKey_F9, false) && editor)
     {
         int line, col;
-        editor.GetMainCursor(line, col);
+        editor->GetMainCursor(line, col);
         debugger->ToggleBreakpoint(selected_stack_section, line + 1);
     }
 
@@ -538,17 +1317,7 @@ void asIDBImGuiFrontend::RenderWatch()
             auto &val = f[n];
 
             if (val.dirty)
-            {
-                val.result = cache->ResolveExpression(val.name, selected_stack_entry);
-
-                // TODO: modifier passed through resolve expression?
-                if (val.result)
-                    val.type = cache->GetTypeNameFromType({ val.result->idKey.typeId });
-                else
-                    val.type = "";
-
-                val.dirty = false;
-            }
+                cache->RefreshWatch(val, selected_stack_entry);
 
             bool right_clicked = RenderDebuggerVariable(val, nullptr);
 
@@ -574,6 +1343,294 @@ void asIDBImGuiFrontend::RenderWatch()
     }
 }
 
+void asIDBImGuiFrontend::RenderAllocations()
+{
+    bool enabled = asIDBAllocProfiler::IsEnabled();
+
+    if (ImGui::Checkbox("Enabled", &enabled))
+        asIDBAllocProfiler::SetEnabled(enabled);
+
+    auto sites = asIDBAllocProfiler::Collect();
+    auto siteKey = [](const asIDBAllocSite &site) { return (uint64_t(site.functionId) + 1) << 32 | uint32_t(site.line); };
+
+    ImGui::SameLine();
+    if (ImGui::Button("Set Baseline"))
+    {
+        allocBaseline.clear();
+
+        for (auto &site : sites)
+            allocBaseline[siteKey(site)] = site.liveBytes;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear Baseline"))
+        allocBaseline.clear();
+
+    int64_t liveBytes = 0, liveCount = 0, growth = 0;
+
+    for (auto &site : sites)
+    {
+        liveBytes += site.liveBytes;
+        liveCount += site.liveCount;
+    }
+
+    for (auto &[key, bytes] : allocBaseline)
+        growth -= bytes;
+
+    growth += liveBytes;
+
+    ImGui::Text("Live: %lld bytes in %lld allocations", (long long) liveBytes, (long long) liveCount);
+    if (!allocBaseline.empty())
+    {
+        ImGui::SameLine();
+        ImGui::Text("(%+lld bytes since baseline)", (long long) growth);
+    }
+
+    auto getGrowth = [&](const asIDBAllocSite &site) -> int64_t {
+        auto f = allocBaseline.find(siteKey(site));
+        return site.liveBytes - (f == allocBaseline.end() ? 0 : f->second);
+    };
+
+    if (!ImGui::BeginTable("##Allocations", 6,
+        ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH |
+        ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg |
+        ImGuiTableFlags_NoBordersInBody | ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY))
+        return;
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Line", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Count", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Bytes", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Live", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Growth", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableHeadersRow();
+
+    if (auto specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsCount)
+    {
+        auto &spec = specs->Specs[0];
+
+        std::sort(sites.begin(), sites.end(), [&](const asIDBAllocSite &a, const asIDBAllocSite &b) {
+            int64_t l, r;
+
+            switch (spec.ColumnIndex)
+            {
+            case 0: l = a.functionId; r = b.functionId; break;
+            case 1: l = a.line; r = b.line; break;
+            case 2: l = a.count; r = b.count; break;
+            case 3: l = a.bytes; r = b.bytes; break;
+            case 4: l = a.liveBytes; r = b.liveBytes; break;
+            default: l = getGrowth(a); r = getGrowth(b); break;
+            }
+
+            return spec.SortDirection == ImGuiSortDirection_Ascending ? l < r : l > r;
+        });
+    }
+
+    // function names can only be looked up
+    // safely while we're broken.
+    asIScriptEngine *engine = debugger->cache ? debugger->cache->ctx->GetEngine() : nullptr;
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int) sites.size());
+
+    while (clipper.Step())
+    {
+        for (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++)
+        {
+            auto &site = sites[n];
+            asIScriptFunction *func = engine ? engine->GetFunctionById(site.functionId) : nullptr;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (func)
+                ImGui::TextUnformatted(func->GetDeclaration(true, true));
+            else
+                ImGui::TextDisabled("function #%d", site.functionId);
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", site.line);
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", (long long) site.count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", (long long) site.bytes);
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", (long long) site.liveBytes);
+            ImGui::TableNextColumn();
+            ImGui::Text("%+lld", (long long) getGrowth(site));
+        }
+    }
+
+    ImGui::EndTable();
+}
+
+void asIDBImGuiFrontend::RenderProfiler()
+{
+    if (!debugger->profiling)
+    {
+        if (ImGui::Button("Start"))
+            debugger->StartProfiling();
+    }
+    else if (ImGui::Button("Stop"))
+        debugger->StopProfiling();
+
+    // copy out the results, so the lock isn't held
+    // for the whole table.
+    std::vector<asIDBFunctionProfile> functions;
+    int64_t elapsed;
+    {
+        std::scoped_lock lock(debugger->profile.mutex);
+
+        for (auto &fp : debugger->profile.functions)
+            if (fp.calls)
+                functions.push_back(fp);
+
+        elapsed = debugger->profile.elapsed;
+    }
+
+    ImGui::SameLine();
+    if (debugger->profiling)
+        ImGui::TextDisabled("profiling...");
+    else if (elapsed)
+        ImGui::Text("%.3f ms profiled", elapsed / 1000000.0);
+
+    if (!ImGui::BeginTable("##Profiler", 5,
+        ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH |
+        ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg |
+        ImGuiTableFlags_NoBordersInBody | ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY))
+        return;
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Inclusive ms", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Exclusive ms", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Avg us", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableHeadersRow();
+
+    auto average = [](const asIDBFunctionProfile &fp) { return (double) fp.inclusive / fp.calls; };
+
+    if (auto specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsCount)
+    {
+        auto &spec = specs->Specs[0];
+
+        auto less = [&](const asIDBFunctionProfile &a, const asIDBFunctionProfile &b) {
+            switch (spec.ColumnIndex)
+            {
+            case 0: return a.name < b.name;
+            case 1: return a.calls < b.calls;
+            case 2: return a.inclusive < b.inclusive;
+            case 3: return a.exclusive < b.exclusive;
+            default: return average(a) < average(b);
+            }
+        };
+
+        std::sort(functions.begin(), functions.end(), [&](const asIDBFunctionProfile &a, const asIDBFunctionProfile &b) {
+            return spec.SortDirection == ImGuiSortDirection_Ascending ? less(a, b) : less(b, a);
+        });
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int) functions.size());
+
+    while (clipper.Step())
+    {
+        for (int n = clipper.DisplayStart; n < clipper.DisplayEnd; n++)
+        {
+            auto &fp = functions[n];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(fp.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long) fp.calls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", fp.inclusive / 1000000.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", fp.exclusive / 1000000.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", average(fp) / 1000.0);
+        }
+    }
+
+    ImGui::EndTable();
+}
+
+void asIDBImGuiFrontend::RenderGCMonitor()
+{
+    auto &monitor = *debugger->gc_monitor;
+
+    if (ImGui::SmallButton("Reset"))
+        monitor.Reset();
+
+    std::scoped_lock lock(monitor.mutex);
+
+    ImGui::SameLine();
+    ImGui::Text("Objects: %u, destroyed: %u, detected: %u", monitor.current_size, monitor.total_destroyed, monitor.total_detected);
+
+    char overlay[64];
+    int offset = (int) monitor.history_offset;
+    int count = (int) monitor.history_size;
+
+    float maxPause = 0;
+    for (float v : monitor.pause_history)
+        maxPause = std::max(maxPause, v);
+    snprintf(overlay, sizeof(overlay), "pause (max %.3f ms)", maxPause);
+    ImGui::PlotLines("##Pause", monitor.pause_history.data(), count, offset, overlay, 0.0f, FLT_MAX, ImVec2(-1, 60));
+
+    snprintf(overlay, sizeof(overlay), "objects (%u)", monitor.current_size);
+    ImGui::PlotLines("##Size", monitor.size_history.data(), count, offset, overlay, 0.0f, FLT_MAX, ImVec2(-1, 60));
+
+    ImGui::PlotHistogram("##New", monitor.new_history.data(), count, offset, "new objects", 0.0f, FLT_MAX, ImVec2(-1, 40));
+
+    if (ImGui::BeginTable("##GCStages", 6, ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Stage", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Avg ms", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Max ms", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Destroyed", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Detected", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+
+        for (int i = 0; i < (int) asIDBGCStage::Count; i++)
+        {
+            auto &stats = monitor.stages[i];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::RadioButton(asIDBGCMonitor::GetStageName((asIDBGCStage) i), &gcHistogramStage, i);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long) stats.calls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.calls ? stats.total_ms / stats.calls : 0.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.max_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long) stats.destroyed);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long) stats.detected);
+        }
+
+        ImGui::EndTable();
+    }
+
+    // pause time histogram for the selected stage; trim
+    // the empty buckets off of the end.
+    auto &stats = monitor.stages[gcHistogramStage];
+    std::array<float, asIDBGCStageStats::num_buckets> buckets;
+    int numBuckets = 1;
+
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        buckets[i] = (float) stats.histogram[i];
+
+        if (stats.histogram[i])
+            numBuckets = (int) i + 1;
+    }
+
+    snprintf(overlay, sizeof(overlay), "pauses, up to %llu us", 2ull << (numBuckets - 1));
+    ImGui::PlotHistogram("##PauseHistogram", buckets.data(), numBuckets, 0, overlay, 0.0f, FLT_MAX, ImVec2(-1, 80));
+}
+
 bool asIDBImGuiFrontend::RenderDebuggerVariable(asIDBVarViewBase &varView, const char *filter)
 {
     asIDBCache *cache = debugger->cache.get();
@@ -622,10 +1679,23 @@ bool asIDBImGuiFrontend::RenderDebuggerVariable(asIDBVarViewBase &varView, const
         {
             if (var.value.disabled)
                 ImGui::BeginDisabled(true);
-            auto s = var.value.value.substr(0, 32);
-            ImGui::TextUnformatted(s.data(), s.data() + s.size());
+            ImGui::TextUnformatted(var.value.value.data(), var.value.value.data() + var.value.value.size());
             if (var.value.disabled)
                 ImGui::EndDisabled();
+
+            // only a preview is stored, so the full value
+            // has to be fetched to be viewed.
+            if (var.value.truncated)
+            {
+                ImGui::SameLine();
+
+                if (ImGui::SmallButton("View"))
+                {
+                    valueViewerName = varView.name;
+                    valueViewerText = cache->evaluators.FetchFullValue(*cache, varId);
+                    showValueViewer = true;
+                }
+            }
         }
         ImGui::TableNextColumn();
         ImGui::TextUnformatted(varView.type.data(), varView.type.data() + varView.type.size());
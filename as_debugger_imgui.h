@@ -38,6 +38,18 @@ public:
     // depends on the old script.
     void ChangeScript();
 
+    // make the given section the selected one, opening
+    // (or reloading) its tab if needed.
+    void OpenSourceTab(std::string_view section);
+    void CloseSourceTab(std::string_view section);
+
+    // open the given section and move the cursor
+    // to the given (one-based) line, if any.
+    void GoToLine(std::string_view section, int line);
+
+    // apply the debugger's settings to a new source editor.
+    void SetupEditor(TextEditor &editor);
+
     // this is the loop for the thread.
     // return false if the UI has decided to exit.
     bool Render(bool full);
@@ -47,6 +59,9 @@ public:
     void RenderLocals(const char *filter, asIDBLocalKey stack_entry);
     void RenderGlobals(const char *filter, bool showConstants, bool showNamespaced);
     void RenderWatch();
+    void RenderAllocations();
+    void RenderGCMonitor();
+    void RenderProfiler();
 
     virtual void SetWindowVisibility(bool visible) = 0;
     bool IsWindowVisible() { return isVisible; }
@@ -57,7 +72,29 @@ protected:
     bool isVisible = true, wasVisible = false;
     bool showExceptionWindow = true;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
-    TextEditor editor;
+
+    // one retained editor per open section, so switching
+    // between frames in different sections doesn't have
+    // to reload (and lose the state of) the source.
+    struct asIDBSourceTab
+    {
+        std::string_view            section;
+        std::unique_ptr<TextEditor> editor;
+        size_t                      size = 0;        // source bytes
+        uint64_t                    last_used = 0;
+        uint32_t                    generation = 0;  // debugger->module_generation when loaded
+        std::string                 previous;        // source before the last reload, if it changed
+        size_t                      source_hash = 0; // of the raw source last loaded; 0 if none
+    };
+
+    std::vector<asIDBSourceTab> sourceTabs; // in tab order
+    TextEditor *editor = nullptr; // selected section's editor
+    uint64_t sourceTabClock = 0;
+    bool selectSourceTab = false;
+
+    // least recently used tabs are closed once the
+    // sources of the open tabs add up to more than this.
+    static constexpr size_t sourceTabMemoryLimit = 32 * 1024 * 1024;
 
     int selected_context = 0;
     int selected_stack_entry = 0;
@@ -70,6 +107,95 @@ protected:
 
     bool resetOpenStates = false;
 
+    // full value of a truncated variable, fetched
+    // when the user asks to view it.
+    bool showValueViewer = false;
+    std::string valueViewerName;
+    std::string valueViewerText;
+
+    // live bytes per allocation site when the
+    // baseline was taken; see RenderAllocations.
+    std::unordered_map<uint64_t, int64_t> allocBaseline;
+
+    // stage shown in the GC pause histogram.
+    int gcHistogramStage = 0;
+
+    // inline values for the Source window; built for the
+    // selected frame and memoized per line until it changes.
+    struct asIDBInlineLocal
+    {
+        int                         index;
+        std::optional<std::string>  value; // evaluated on first use
+    };
+
+    asIDBCache *inlineValuesCache = nullptr;
+    int inlineValuesStackEntry = -1;
+    std::string_view inlineValuesSection;
+    int inlineValuesFirstLine = 0, inlineValuesLastLine = -1; // zero-based, inclusive
+    std::unordered_map<std::string, asIDBInlineLocal> inlineLocals;
+    std::unordered_map<int, std::string> inlineValues;
+    std::vector<std::string> inlineIdentifiers; // scratch
+
+    // get the inline values to show after the given line.
+    std::string_view GetInlineValues(int line);
+
+    // hover evaluation for the Source window; results are
+    // memoized per expression until the frame changes.
+    asIDBCache *hoverCache = nullptr;
+    int hoverStackEntry = -1;
+    std::string hoverExpr;
+    std::unordered_map<std::string, asIDBWatchEntry> hoverResults;
+
+    // open/render the hover evaluation popup; called
+    // right after the Source window's editor.
+    void RenderHoverEvaluation();
+
+    // registered names for the source editors to
+    // highlight; rebuilt from debugger->engine_symbols.
+    TextEditor::Identifiers engineIdentifiers;
+    uint32_t engineIdentifiersGeneration = 0;
+
+    // Ctrl+P quick-open over section names and function
+    // declarations; the index is rebuilt when a module is.
+    struct asIDBQuickOpenTarget
+    {
+        std::string_view section;
+        int              line; // 0 for the section itself
+    };
+
+    asIDBFuzzyIndex quickOpenIndex;
+    std::vector<asIDBQuickOpenTarget> quickOpenTargets; // same order as quickOpenIndex
+    uint32_t quickOpenGeneration = 0;
+    bool quickOpenIndexed = false;
+    char quickOpenQuery[256] {};
+    std::vector<asIDBFuzzyIndex::Result> quickOpenResults;
+    int quickOpenSelected = 0;
+
+    // open/render the quick-open popup.
+    void RenderQuickOpen();
+
+    // expression to find the declaration of, and the
+    // declarations to pick from when there's several.
+    std::string definitionExpr;
+    std::vector<asIDBSymbolRef> definitionCandidates;
+
+    // resolve definitionExpr, opening its declaration
+    // or a popup to pick one.
+    void RenderGoToDefinition();
+
+    // side by side diff of a section against its source
+    // from before the last reload; see asIDBSourceTab.
+    bool showDiff = false;
+    std::string_view diffSection;
+    asIDBLineDiff diff;
+    TextEditor diffOld, diffNew;
+    TextEditor *diffFollower = nullptr; // side that was scrolled to match the other
+    int diffOldFirstLine = -1, diffNewFirstLine = -1;
+
+    // diff the given section's open tab against its previous source.
+    void OpenDiff(std::string_view section);
+    void RenderDiff();
+
     // renders a single debugger variable
     bool RenderDebuggerVariable(asIDBVarViewBase &varView, const char *filter);
 